@@ -0,0 +1,2704 @@
+#ifndef BASIC_SIGNAL_H
+#define BASIC_SIGNAL_H
+
+#include <new>
+#include <span>
+#include <atomic>
+#include <memory>
+#include <tuple>
+#include <future>
+#include <coroutine>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <ranges>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <functional>
+#include <source_location>
+#include <type_traits>
+#include <condition_variable>
+
+// Inline buffer size of melo::delegate, callables larger than this are heap allocated
+#ifndef MELO_DELEGATE_SIZE
+#define MELO_DELEGATE_SIZE (4 * sizeof(void*))
+#endif
+
+// Number of tasks a melo::dispatch_queue holds, must be a power of two
+#ifndef MELO_DISPATCH_QUEUE_SIZE
+#define MELO_DISPATCH_QUEUE_SIZE 4096
+#endif
+
+// Define to 1 to count emits and dispatches per signal, see melo::signal_stats
+#ifndef MELO_SIGNAL_STATS
+#define MELO_SIGNAL_STATS 0
+#endif
+
+#if MELO_SIGNAL_STATS
+#include <ostream>
+#endif
+
+namespace melo {
+
+template <typename Signature, std::size_t Size = MELO_DELEGATE_SIZE>
+class delegate;
+
+// Type-erased callable similar to std::function, with a fixed inline buffer.
+// Trivially copyable callables (function pointers, member function bindings,
+// lambdas capturing pointers or integers) are relocated with a plain memcpy.
+template <typename R, typename... Args, std::size_t Size>
+class delegate<R(Args...), Size>
+{
+private:
+    enum class Operation { Copy, Move, Destroy };
+
+    using Invoker = R (*)(void*, Args&&...);
+    using Manager = void (*)(Operation, void*, void*);
+
+    template <typename F>
+    static constexpr bool local = sizeof(F) <= Size && alignof(F) <= alignof(std::max_align_t)
+                                  && std::is_nothrow_move_constructible_v<F>;
+
+    template <typename F>
+    static constexpr bool trivial = local<F> && std::is_trivially_copyable_v<F>;
+
+    // Dedicated representation for member functions, the instance and the
+    // member pointer are stored side by side instead of in a capturing lambda
+    template <typename ClassType, typename Method>
+    struct Member {
+        ClassType* instance;
+        Method method;
+
+        R operator()(Args&&... args) const
+        {
+            if constexpr (std::is_void_v<R>)
+                std::invoke(method, instance, std::forward<Args>(args)...);
+            else
+                return std::invoke(method, instance, std::forward<Args>(args)...);
+        }
+    };
+
+    alignas(std::max_align_t) mutable unsigned char storage[Size] = {};  // Zeroed, memcpy relocates it whole
+    Invoker invoker = nullptr;
+    Manager manager = nullptr;  // Only set for callables that are not trivially copyable
+
+    template <typename F>
+    static inline F* target(void* data)
+    {
+        if constexpr (local<F>)
+            return std::launder(static_cast<F*>(data));
+        else
+            return *static_cast<F**>(data);
+    }
+
+    template <typename F>
+    static R invoke(void* data, Args&&... args)
+    {
+        // Values returned to a void delegate are discarded, as std::function does
+        if constexpr (std::is_void_v<R>)
+            std::invoke(*target<F>(data), std::forward<Args>(args)...);
+        else
+            return std::invoke(*target<F>(data), std::forward<Args>(args)...);
+    }
+
+    template <typename F>
+    static void manage(Operation operation, void* dst, void* src)
+    {
+        switch (operation) {
+        case Operation::Copy:
+            if constexpr (local<F>)
+                ::new (dst) F(*target<F>(src));
+            else
+                *static_cast<F**>(dst) = new F(*target<F>(src));
+            break;
+        case Operation::Move:
+            if constexpr (local<F>) {
+                ::new (dst) F(std::move(*target<F>(src)));
+                target<F>(src)->~F();
+            } else {
+                *static_cast<F**>(dst) = *static_cast<F**>(src);
+            }
+            break;
+        case Operation::Destroy:
+            if constexpr (local<F>)
+                target<F>(dst)->~F();
+            else
+                delete target<F>(dst);
+            break;
+        }
+    }
+
+    inline void copy(const delegate& other)
+    {
+        if (other.manager)
+            other.manager(Operation::Copy, storage, other.storage);
+        else
+            std::memcpy(storage, other.storage, Size);
+
+        invoker = other.invoker;
+        manager = other.manager;
+    }
+
+    inline void move(delegate& other) noexcept
+    {
+        if (other.manager)
+            other.manager(Operation::Move, storage, other.storage);
+        else
+            std::memcpy(storage, other.storage, Size);
+
+        invoker = std::exchange(other.invoker, nullptr);
+        manager = std::exchange(other.manager, nullptr);
+    }
+
+    inline void reset() noexcept
+    {
+        if (manager)
+            manager(Operation::Destroy, storage, nullptr);
+
+        invoker = nullptr;
+        manager = nullptr;
+    }
+
+public:
+    delegate() noexcept = default;
+    delegate(std::nullptr_t) noexcept {}
+    ~delegate() { reset(); }
+
+    delegate(const delegate& other) { copy(other); }
+    delegate(delegate&& other) noexcept { move(other); }
+
+    delegate& operator=(const delegate& other)
+    {
+        if (this != &other) {
+            reset();
+            copy(other);
+        }
+        return *this;
+    }
+
+    delegate& operator=(delegate&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            move(other);
+        }
+        return *this;
+    }
+
+    // Support function pointers, lambdas and any other callable object
+    template <typename Function, typename F = std::decay_t<Function>>
+    requires (!std::same_as<F, delegate> && std::copy_constructible<F> && std::is_invocable_r_v<R, F&, Args...>)
+    delegate(Function&& function)
+    {
+        if constexpr (std::is_pointer_v<std::remove_cvref_t<Function>> || std::is_member_pointer_v<F>) {
+            if (!function)
+                return;
+        }
+
+        if constexpr (local<F>)
+            ::new (storage) F(std::forward<Function>(function));
+        else
+            *reinterpret_cast<F**>(storage) = new F(std::forward<Function>(function));
+
+        invoker = &invoke<F>;
+
+        if constexpr (!trivial<F>)
+            manager = &manage<F>;
+    }
+
+    // Support member functions bound to an instance
+    template <typename ClassType, typename Method>
+    requires std::is_invocable_r_v<R, const Method&, ClassType*, Args...>
+    delegate(ClassType* instance, Method method)
+        : delegate(Member<ClassType, Method>{instance, method})
+    {
+    }
+
+    explicit operator bool() const noexcept { return invoker != nullptr; }
+
+    R operator()(Args... args) const
+    {
+        return invoker(storage, std::forward<Args>(args)...);
+    }
+};
+
+// Counters of a signal, only collected when MELO_SIGNAL_STATS is 1
+struct signal_stats
+{
+    const char* name = nullptr;
+    std::uint64_t emits = 0;
+    std::uint64_t direct_calls = 0;
+    std::uint64_t queued_calls = 0;
+    std::uint64_t dead_skips = 0;           // Disconnected or dead slots skipped by emits
+    std::chrono::nanoseconds lock_wait{0};  // Time connect and disconnect waited for the writer lock
+    std::size_t max_slots = 0;              // Longest slot list published
+};
+
+namespace detail {
+
+// Arguments taken by value are passed on to slots by const reference, so a
+// shared payload can be handed to every queued slot without copies
+template <typename T>
+using slot_parameter = std::conditional_t<std::is_reference_v<T>, T, const T&>;
+
+struct slot_key
+{
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0;
+};
+
+#if MELO_SIGNAL_STATS
+// Relaxed counters, emitters add to them once per emit
+class signal_counters
+{
+private:
+    std::atomic<std::uint64_t> emits{0};
+    std::atomic<std::uint64_t> direct{0};
+    std::atomic<std::uint64_t> queued{0};
+    std::atomic<std::uint64_t> dead{0};
+    std::atomic<std::int64_t> lock_wait{0};
+    std::atomic<std::size_t> max_slots{0};
+
+public:
+    void emitted(std::size_t count, std::size_t direct_calls, std::size_t queued_calls, std::size_t skipped) noexcept
+    {
+        emits.fetch_add(count, std::memory_order_relaxed);
+        direct.fetch_add(direct_calls, std::memory_order_relaxed);
+        queued.fetch_add(queued_calls, std::memory_order_relaxed);
+        dead.fetch_add(skipped, std::memory_order_relaxed);
+    }
+
+    void published(std::size_t size) noexcept
+    {
+        std::size_t max = max_slots.load(std::memory_order_relaxed);
+
+        while (size > max && !max_slots.compare_exchange_weak(max, size, std::memory_order_relaxed)) {}
+    }
+
+    std::unique_lock<std::mutex> lock(std::mutex& mutex)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> locker(mutex);
+
+        lock_wait.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+        return locker;
+    }
+
+    signal_stats stats() const noexcept
+    {
+        signal_stats stats;
+        stats.emits = emits.load(std::memory_order_relaxed);
+        stats.direct_calls = direct.load(std::memory_order_relaxed);
+        stats.queued_calls = queued.load(std::memory_order_relaxed);
+        stats.dead_skips = dead.load(std::memory_order_relaxed);
+        stats.lock_wait = std::chrono::nanoseconds(lock_wait.load(std::memory_order_relaxed));
+        stats.max_slots = max_slots.load(std::memory_order_relaxed);
+        return stats;
+    }
+};
+#else
+// Compiled out, every call is a no-op
+struct signal_counters
+{
+    void emitted(std::size_t, std::size_t, std::size_t, std::size_t) noexcept {}
+    void published(std::size_t) noexcept {}
+    std::unique_lock<std::mutex> lock(std::mutex& mutex) { return std::unique_lock<std::mutex>(mutex); }
+    signal_stats stats() const noexcept { return {}; }
+};
+#endif
+
+// Frees the slot snapshots replaced by connect() and disconnect() once no
+// emission can still iterate them, without emitters sharing any write. Each
+// emission announces the epoch it started in on its thread's record, a
+// replaced snapshot is retired with the epoch it was replaced in and freed
+// when every running emission started after it.
+class snapshot_domain
+{
+private:
+    struct Record {
+        std::atomic<std::uint64_t> active{0};  // Epoch of the running emission, 0 when idle
+        std::uint32_t depth = 0;               // Nested emissions, only used by the owner thread
+        bool used = true;                      // Guarded by mutex, records of exited threads are reused
+        Record* next = nullptr;
+    };
+
+    struct Retired {
+        std::shared_ptr<const void> snapshot;
+        std::uint64_t epoch;
+    };
+
+    // Gives the record back when its thread exits
+    struct Owner {
+        Record* const record;
+
+        ~Owner()
+        {
+            std::lock_guard<std::mutex> locker(instance().mutex);
+            record->active.store(0, std::memory_order_relaxed);
+            record->used = false;
+        }
+    };
+
+    std::atomic<std::uint64_t> epoch{1};
+    std::atomic<std::size_t> pending{0};  // Size of retired, read by emitters without locking
+    std::mutex mutex;
+    Record* records = nullptr;
+    std::vector<Retired> retired;
+
+    Record* acquire()
+    {
+        std::lock_guard<std::mutex> locker(mutex);
+
+        for (Record* record = records; record; record = record->next) {
+            if (!record->used) {
+                record->used = true;
+                return record;
+            }
+        }
+
+        records = new Record{.next = records};
+        return records;
+    }
+
+    Record& local()
+    {
+        thread_local const Owner owner{acquire()};
+        return *owner.record;
+    }
+
+    // Moves the snapshots no emission can reach into freed, called locked
+    void collect(std::vector<Retired>& freed)
+    {
+        std::uint64_t oldest = UINT64_MAX;
+
+        for (const Record* record = records; record; record = record->next) {
+            const std::uint64_t active = record->active.load(std::memory_order_seq_cst);
+
+            if (active)
+                oldest = std::min(oldest, active);
+        }
+
+        const auto reachable = std::partition(retired.begin(), retired.end(), [&](const Retired& item) { return item.epoch >= oldest; });
+        std::move(reachable, retired.end(), std::back_inserter(freed));
+        retired.erase(reachable, retired.end());
+        pending.store(retired.size(), std::memory_order_relaxed);
+    }
+
+public:
+    // Never destroyed, emissions may still run during static destruction
+    static snapshot_domain& instance()
+    {
+        static snapshot_domain* const domain = new snapshot_domain;
+        return *domain;
+    }
+
+    // The announcement is sequentially consistent with the snapshot load
+    // that follows it and with the scan in collect()
+    void enter()
+    {
+        Record& record = local();
+
+        if (record.depth++ == 0)
+            record.active.store(epoch.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+    }
+
+    // The last emission to end frees what it held back, if no other thread is
+    // already freeing
+    void leave()
+    {
+        Record& record = local();
+
+        if (--record.depth != 0)
+            return;
+
+        record.active.store(0, std::memory_order_release);
+
+        if (pending.load(std::memory_order_relaxed) == 0)
+            return;
+
+        std::vector<Retired> freed;
+        std::unique_lock<std::mutex> locker(mutex, std::try_to_lock);
+
+        if (locker) {
+            collect(freed);
+            locker.unlock();
+        }
+    }
+
+    // Called after the snapshot was replaced, the slots it frees are
+    // destroyed outside the lock
+    void retire(std::shared_ptr<const void> snapshot)
+    {
+        std::vector<Retired> freed;
+        std::lock_guard<std::mutex> locker(mutex);
+
+        retired.push_back(Retired{std::move(snapshot), epoch.fetch_add(1, std::memory_order_seq_cst)});
+        collect(freed);
+    }
+};
+
+// Current snapshot of a signal for the length of an emission
+template <typename Slots>
+class snapshot_guard
+{
+private:
+    snapshot_domain& domain = snapshot_domain::instance();
+    const Slots* const slots;
+
+    static const Slots* enter(snapshot_domain& domain, const std::atomic<const Slots*>& current)
+    {
+        domain.enter();
+        return current.load(std::memory_order_seq_cst);
+    }
+
+public:
+    explicit snapshot_guard(const std::atomic<const Slots*>& current) : slots(enter(domain, current)) {}
+    ~snapshot_guard() { domain.leave(); }
+
+    snapshot_guard(const snapshot_guard&) = delete;
+    snapshot_guard& operator=(const snapshot_guard&) = delete;
+
+    const Slots& operator*() const noexcept { return *slots; }
+    const Slots* operator->() const noexcept { return slots; }
+};
+
+// Lets connection handles reach the slots of a signal without knowing its arguments
+struct slot_table
+{
+    std::atomic<const char*> name{nullptr};
+    [[no_unique_address]] signal_counters counters;
+
+#if MELO_SIGNAL_STATS
+    slot_table();
+    virtual ~slot_table();
+#else
+    virtual ~slot_table() = default;
+#endif
+
+    signal_stats stats() const
+    {
+        signal_stats stats = counters.stats();
+        stats.name = name.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    virtual void disconnect(std::span<const slot_key> keys) = 0;
+    virtual bool connected(slot_key key) = 0;
+    virtual std::uint64_t dropped(slot_key key) = 0;
+};
+
+} // namespace detail
+
+#if MELO_SIGNAL_STATS
+// Every live signal, to find the hot ones
+class signal_registry
+{
+private:
+    friend struct detail::slot_table;
+
+    struct Tables {
+        std::mutex mutex;
+        std::vector<const detail::slot_table*> tables;
+    };
+
+    static Tables& tables()
+    {
+        static Tables tables;
+        return tables;
+    }
+
+public:
+    static std::vector<signal_stats> stats()
+    {
+        Tables& registry = tables();
+        std::lock_guard<std::mutex> locker(registry.mutex);
+
+        std::vector<signal_stats> result;
+        result.reserve(registry.tables.size());
+
+        for (const detail::slot_table* table : registry.tables)
+            result.push_back(table->stats());
+
+        return result;
+    }
+
+    // One line per signal, unnamed ones are shown by address
+    static void dump(std::ostream& stream)
+    {
+        Tables& registry = tables();
+        std::lock_guard<std::mutex> locker(registry.mutex);
+
+        for (const detail::slot_table* table : registry.tables) {
+            const signal_stats stats = table->stats();
+
+            if (stats.name)
+                stream << stats.name;
+            else
+                stream << static_cast<const void*>(table);
+
+            stream << ": emits=" << stats.emits << " direct=" << stats.direct_calls << " queued=" << stats.queued_calls
+                   << " dead=" << stats.dead_skips << " lock_wait_us=" << stats.lock_wait.count() / 1000
+                   << " max_slots=" << stats.max_slots << '\n';
+        }
+    }
+};
+
+inline detail::slot_table::slot_table()
+{
+    signal_registry::Tables& registry = signal_registry::tables();
+    std::lock_guard<std::mutex> locker(registry.mutex);
+    registry.tables.push_back(this);
+}
+
+inline detail::slot_table::~slot_table()
+{
+    signal_registry::Tables& registry = signal_registry::tables();
+    std::lock_guard<std::mutex> locker(registry.mutex);
+    registry.tables.erase(std::find(registry.tables.begin(), registry.tables.end(), this));
+}
+#endif
+
+// Handle to a single slot returned by connect(), stays valid (and harmless)
+// after the slot or the signal itself is gone
+class connection
+{
+private:
+    friend class connection_group;
+
+    std::weak_ptr<detail::slot_table> table;
+    detail::slot_key key;
+
+public:
+    connection() noexcept = default;
+    connection(std::weak_ptr<detail::slot_table> table, detail::slot_key key) noexcept
+        : table(std::move(table)), key(key)
+    {
+    }
+
+    bool connected() const
+    {
+        const std::shared_ptr<detail::slot_table> owner = table.lock();
+        return owner && owner->connected(key);
+    }
+
+    // Queued calls dropped because the slot's queue was full
+    std::uint64_t dropped() const
+    {
+        const std::shared_ptr<detail::slot_table> owner = table.lock();
+        return owner ? owner->dropped(key) : 0;
+    }
+
+    void disconnect()
+    {
+        if (const std::shared_ptr<detail::slot_table> owner = table.lock())
+            owner->disconnect(std::span<const detail::slot_key>(&key, 1));
+
+        table.reset();
+    }
+};
+
+// Disconnects its slot when destroyed
+class scoped_connection
+{
+private:
+    connection handle;
+
+public:
+    scoped_connection() noexcept = default;
+    scoped_connection(connection handle) noexcept : handle(std::move(handle)) {}
+    ~scoped_connection() { handle.disconnect(); }
+
+    scoped_connection(const scoped_connection&) = delete;
+    scoped_connection& operator=(const scoped_connection&) = delete;
+
+    scoped_connection(scoped_connection&& other) noexcept : handle(other.release()) {}
+
+    scoped_connection& operator=(scoped_connection&& other) noexcept
+    {
+        if (this != &other) {
+            handle.disconnect();
+            handle = other.release();
+        }
+        return *this;
+    }
+
+    bool connected() const { return handle.connected(); }
+    std::uint64_t dropped() const { return handle.dropped(); }
+    void disconnect() { handle.disconnect(); }
+
+    // Gives up ownership without disconnecting
+    connection release() noexcept { return std::exchange(handle, connection()); }
+};
+
+// Holds many connections and disconnects them together, locking each signal
+// only once however many of its slots are in the group
+class connection_group
+{
+private:
+    std::vector<connection> connections;
+
+public:
+    connection_group() = default;
+    ~connection_group() { disconnect(); }
+
+    connection_group(const connection_group&) = delete;
+    connection_group& operator=(const connection_group&) = delete;
+
+    connection_group(connection_group&&) noexcept = default;
+
+    connection_group& operator=(connection_group&& other) noexcept
+    {
+        if (this != &other) {
+            disconnect();
+            connections = std::move(other.connections);
+        }
+        return *this;
+    }
+
+    void add(connection handle) { connections.push_back(std::move(handle)); }
+    connection_group& operator+=(connection handle)
+    {
+        add(std::move(handle));
+        return *this;
+    }
+
+    std::size_t size() const noexcept { return connections.size(); }
+    bool empty() const noexcept { return connections.empty(); }
+
+    void disconnect()
+    {
+        const auto by_signal = [](const connection& a, const connection& b) {
+            return a.table.owner_before(b.table);
+        };
+
+        std::sort(connections.begin(), connections.end(), by_signal);
+
+        std::vector<detail::slot_key> keys;
+        keys.reserve(connections.size());
+
+        for (auto first = connections.begin(); first != connections.end();) {
+            const auto last = std::upper_bound(first, connections.end(), *first, by_signal);
+
+            if (const std::shared_ptr<detail::slot_table> owner = first->table.lock()) {
+                keys.clear();
+
+                for (auto it = first; it != last; ++it)
+                    keys.push_back(it->key);
+
+                owner->disconnect(keys);
+            }
+
+            first = last;
+        }
+
+        connections.clear();
+    }
+};
+
+// Completion of an emission started with emit_async()
+class emission
+{
+private:
+    std::shared_ptr<const std::atomic<bool>> done;
+
+public:
+    explicit emission(std::shared_ptr<const std::atomic<bool>> done) noexcept : done(std::move(done)) {}
+
+    // True once every slot called for the emission returned
+    bool ready() const noexcept { return done->load(std::memory_order_acquire); }
+
+    void wait() const
+    {
+        done->wait(false, std::memory_order_acquire);
+    }
+};
+
+// What happens to a queued call when the slot's queue is full
+enum class overflow_policy
+{
+    block,        // The emitter waits until the receiver made room
+    drop_newest,  // The new call is dropped
+    drop_oldest,  // The oldest pending call is dropped
+    coalesce      // The new call replaces the newest pending one
+};
+
+// Threads running the queued calls of the connections it is given to with
+// slot_options::pool, see melo::thread_pool
+class task_pool
+{
+public:
+    virtual ~task_pool() = default;
+    virtual void post(delegate<void()> task) = 0;
+};
+
+// Per-connection settings, passed as the last argument of connect()
+struct slot_options
+{
+    // Queued calls not yet delivered are merged, the slot then runs once
+    // with the arguments of the newest emission ("latest value wins"). Same
+    // as a queue_limit of 1 with overflow_policy::coalesce. Ignored by
+    // result signals, whose emit() waits for each queued call.
+    bool conflate = false;
+
+    // Maximum number of queued calls waiting for the slot, 0 for unbounded.
+    // Ignored by result signals like conflate.
+    std::size_t queue_limit = 0;
+    overflow_policy overflow = overflow_policy::block;
+
+    // Runs the slot on the pool's threads on every emit, even when emitted
+    // from the thread it is bound to. The pool must outlive the connection,
+    // and a receiver must outlive the pooled calls already running.
+    task_pool* pool = nullptr;
+
+    // Slots with a higher priority are called first, in connection order
+    // among equal priorities
+    int priority = 0;
+};
+
+// Receives the events of every signal without a result once installed,
+// see melo::chrome_tracer. Events of one emit share its emission id, each
+// queued call also gets its own flow id pairing its dispatch with its run.
+class tracer
+{
+private:
+    static inline std::atomic<tracer*> active{nullptr};
+    static inline std::atomic<std::uint64_t> emissions{0};
+    static inline std::atomic<std::uint64_t> flows{0};
+
+public:
+    virtual ~tracer() = default;
+
+    virtual void emit_begin(const char* signal, std::uint64_t emission) = 0;
+    virtual void emit_end(const char* signal, std::uint64_t emission) = 0;
+
+    // A slot is called in place (flow 0), or its call queued to another thread
+    virtual void slot_dispatched(const char* signal, std::uint64_t emission, std::uint64_t flow) = 0;
+
+    // Around a queued call, on the thread running it, with its dispatch's flow
+    virtual void queued_begin(const char* signal, std::uint64_t emission, std::uint64_t flow) = 0;
+    virtual void queued_end(const char* signal, std::uint64_t emission, std::uint64_t flow) = 0;
+
+    // nullptr uninstalls, the tracer must stay alive until queued calls
+    // emitted while it was installed ran
+    static void install(tracer* instance) noexcept { active.store(instance, std::memory_order_release); }
+    static tracer* current() noexcept { return active.load(std::memory_order_acquire); }
+
+    static std::uint64_t next_emission() noexcept { return emissions.fetch_add(1, std::memory_order_relaxed) + 1; }
+    static std::uint64_t next_flow() noexcept { return flows.fetch_add(1, std::memory_order_relaxed) + 1; }
+};
+
+// Slot call that ran longer than the watchdog's budget
+struct slow_call
+{
+    const char* signal = nullptr;  // Name of the signal when the call ran
+    std::source_location origin;   // Where the slot was connected
+    std::chrono::nanoseconds duration{0};
+    std::thread::id thread;
+    bool queued = false;
+};
+
+// Times one slot call out of sample_rate on each thread, direct or queued,
+// and reports the calls running longer than the budget on the thread that
+// ran them. Installed like a melo::tracer, calls cost one atomic load and a
+// thread-local counter when not sampled.
+class watchdog
+{
+private:
+    static inline std::atomic<watchdog*> active{nullptr};
+
+    const std::chrono::nanoseconds budget;
+    const delegate<void(const slow_call&)> report;
+    const std::uint32_t sample_rate;
+
+public:
+    watchdog(std::chrono::nanoseconds budget, delegate<void(const slow_call&)> report, std::uint32_t sample_rate = 32)
+        : budget(budget), report(std::move(report)), sample_rate(std::max<std::uint32_t>(sample_rate, 1))
+    {
+    }
+
+    watchdog(const watchdog&) = delete;
+    watchdog& operator=(const watchdog&) = delete;
+
+    // nullptr uninstalls, the watchdog must stay alive until the slot calls
+    // running while it was installed returned, as they may be sampled
+    static void install(watchdog* instance) noexcept { active.store(instance, std::memory_order_release); }
+    static watchdog* current() noexcept { return active.load(std::memory_order_acquire); }
+
+    // Counts down instead of taking a modulo, a division on every call. A
+    // countdown above the rate was left by a watchdog sampling less often.
+    bool sample() const noexcept
+    {
+        thread_local std::uint32_t countdown = 0;
+
+        if (countdown && countdown <= sample_rate && --countdown)
+            return false;
+
+        countdown = sample_rate;
+        return true;
+    }
+
+    // Runs when the timed call returns, also while it unwinds, so exceptions
+    // thrown by report are dropped
+    void check(std::chrono::steady_clock::time_point start, const char* signal, const std::source_location& origin, bool queued) const noexcept
+    {
+        const auto duration = std::chrono::steady_clock::now() - start;
+
+        if (duration <= budget || !report)
+            return;
+
+        try {
+            report(slow_call{signal, origin, std::chrono::duration_cast<std::chrono::nanoseconds>(duration), std::this_thread::get_id(), queued});
+        } catch (...) {
+        }
+    }
+};
+
+namespace detail {
+
+// Emission being traced, the id is 0 when no tracer was installed. The flow
+// is set per queued call.
+struct trace_point
+{
+    const char* signal = nullptr;
+    std::uint64_t id = 0;
+    std::uint64_t flow = 0;
+};
+
+// Reports the start of an emit or queued call and its end, even if a slot throws
+class trace_scope
+{
+private:
+    tracer* const tracing;
+    const trace_point& point;
+    const bool queued;
+
+public:
+    trace_scope(tracer* tracing, const trace_point& point, bool queued) : tracing(tracing), point(point), queued(queued)
+    {
+        if (!tracing)
+            return;
+
+        if (queued)
+            tracing->queued_begin(point.signal, point.id, point.flow);
+        else
+            tracing->emit_begin(point.signal, point.id);
+    }
+
+    ~trace_scope()
+    {
+        if (!tracing)
+            return;
+
+        if (queued)
+            tracing->queued_end(point.signal, point.id, point.flow);
+        else
+            tracing->emit_end(point.signal, point.id);
+    }
+
+    trace_scope(const trace_scope&) = delete;
+    trace_scope& operator=(const trace_scope&) = delete;
+};
+
+} // namespace detail
+
+// Parallel emission of the direct slots, see basic_signal::set_parallel()
+struct parallel_options
+{
+    // Threads running the partitions besides the emitting one, nullptr to
+    // always call the slots one after the other
+    task_pool* pool = nullptr;
+
+    // Minimum number of slots for an emission to be partitioned
+    std::size_t threshold = 1024;
+
+    // Number of partitions, 0 for one per core
+    std::size_t partitions = 0;
+
+    // Calls the slots in order on the emitting thread, interleaved with the
+    // queued ones as without a pool, for debugging
+    bool deterministic = false;
+};
+
+// Executors decide where slots run. A signal asks its executor for the
+// affinity of a slot when it is connected, and on emit whether that affinity
+// is the current thread (direct call) or else to queue the call there:
+//
+//   struct executor {
+//       using affinity = ...;                        // Stored in each slot
+//       static affinity current();                   // Affinity of the calling thread
+//       template <typename T> static affinity of(T* receiver);
+//       static auto resolve(const affinity&);        // Falsy once the receiver or thread is gone
+//       static bool is_current(const auto& target);  // Direct call if true
+//       static auto thread(const auto& target);      // Identifies the target's thread
+//       static void post(const auto& target, Task&& task);
+//       static bool is_receiver(const affinity&);    // Optional, see melo::is_receiver()
+//   };
+template <typename Executor>
+concept executor = requires(const typename Executor::affinity& affinity, delegate<void()> task) {
+    { Executor::current() } -> std::convertible_to<typename Executor::affinity>;
+    { static_cast<bool>(Executor::resolve(affinity)) };
+    { Executor::is_current(Executor::resolve(affinity)) } -> std::convertible_to<bool>;
+    { Executor::thread(Executor::resolve(affinity)) } -> std::equality_comparable;
+    Executor::post(Executor::resolve(affinity), std::move(task));
+};
+
+// Executors tracking receivers (QObjects) tell them apart from the affinity
+// of a connecting thread with an optional is_receiver(). Pooled slots only
+// follow the lifetime of a receiver, not of the thread they were connected from.
+template <executor Executor>
+inline bool is_receiver(const typename Executor::affinity& affinity)
+{
+    if constexpr (requires { { Executor::is_receiver(affinity) } -> std::convertible_to<bool>; })
+        return Executor::is_receiver(affinity);
+    else
+        return false;
+}
+
+namespace detail {
+
+// Slot storage and connection management shared by all signals, R being the
+// return type of the slots
+template <executor Executor, typename R, typename... Args>
+class signal_base
+{
+protected:
+    using Callback = delegate<R(slot_parameter<Args>...)>;
+    using Affinity = typename Executor::affinity;
+
+    // Arguments of an emission, allocated once and shared by all its queued calls
+    using Payload = std::tuple<std::decay_t<Args>...>;
+
+    // Queued calls waiting for a bounded slot. A single queued call is posted
+    // when the mailbox gets its first payload and delivers all of them.
+    struct Mailbox {
+        std::mutex mutex;
+        std::condition_variable room;
+        std::deque<std::pair<std::shared_ptr<const Payload>, trace_point>> pending;
+        const std::size_t limit;
+        const overflow_policy overflow;
+        std::atomic<std::uint64_t> dropped{0};
+        bool scheduled = false;
+
+        Mailbox(std::size_t limit, overflow_policy overflow) : limit(limit), overflow(overflow) {}
+    };
+
+    struct Slot {
+        Callback callback;
+        Affinity affinity;  // Receiver, or the thread the slot was connected from
+        std::unique_ptr<Mailbox> mailbox;  // Only for bounded slots
+        task_pool* const pool;
+        const bool detached;  // Pooled without a receiver, outlives the connecting thread
+        const int priority;
+        const std::weak_ptr<slot_table> forward;  // Signal this slot forwards to
+        const bool forwards;
+        const std::source_location origin;  // Where connect() was called, for the watchdog
+        std::atomic<const char*> signal{nullptr};  // Kept in sync by set_name()
+        std::uint32_t index = 0;
+        std::atomic<bool> connected{true};
+
+        Slot(Callback&& callback, Affinity&& affinity, const slot_options& options, const std::source_location& origin, const std::shared_ptr<slot_table>& forward)
+            : callback(std::move(callback)), affinity(std::move(affinity)), pool(options.pool),
+              detached(options.pool && !is_receiver<Executor>(this->affinity)), priority(options.priority),
+              forward(forward), forwards(forward != nullptr), origin(origin)
+        {
+            if (options.conflate)
+                mailbox = std::make_unique<Mailbox>(1, overflow_policy::coalesce);
+            else if (options.queue_limit)
+                mailbox = std::make_unique<Mailbox>(options.queue_limit, options.overflow);
+        }
+
+        inline bool alive() const
+        {
+            return connected.load(std::memory_order_acquire) && (detached || Executor::resolve(affinity)) && (!forwards || !forward.expired());
+        }
+
+        // Direct call if true, else the call is queued with schedule()
+        template <typename Target>
+        inline bool runs_here(const Target& target) const
+        {
+            return !pool && Executor::is_current(target);
+        }
+
+        template <typename Target, typename Task>
+        inline void schedule(const Target& target, Task&& task) const
+        {
+            if (pool)
+                pool->post(std::forward<Task>(task));
+            else
+                Executor::post(target, std::forward<Task>(task));
+        }
+
+        // Same, reporting the start and end of the call when it is traced
+        template <typename Target, typename Task>
+        inline void schedule(const Target& target, Task&& task, const trace_point& trace) const
+        {
+            if (!trace.id)
+                schedule(target, std::forward<Task>(task));
+            else
+                schedule(target, [task = std::forward<Task>(task), trace] {
+                    const trace_scope scope(tracer::current(), trace, true);
+                    task();
+                });
+        }
+
+        // Calls the callback, timed when the installed watchdog samples it
+        template <typename... Values>
+        inline R invoke(bool queued, Values&&... values) const
+        {
+            const watchdog* const timer = watchdog::current();
+
+            if (!timer || !timer->sample())
+                return callback(std::forward<Values>(values)...);
+
+            struct Timing {
+                const Slot& slot;
+                const watchdog& timer;
+                const bool queued;
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+                ~Timing() { timer.check(start, slot.signal.load(std::memory_order_relaxed), slot.origin, queued); }
+            } timing{*this, *timer, queued};
+
+            return callback(std::forward<Values>(values)...);
+        }
+
+        // Pooled calls run on any thread, the receiver may have been destroyed
+        // since the emission resolved it
+        inline void call(const Payload& args, bool queued = true) const
+        {
+            if (connected.load(std::memory_order_acquire) && (!pool || detached || Executor::resolve(affinity)))
+                std::apply([&](const auto&... values) { invoke(queued, values...); }, args);
+        }
+
+        // Returns true when a queued call must be posted to deliver the mailbox
+        inline bool enqueue(std::shared_ptr<const Payload> payload, const trace_point& trace)
+        {
+            std::unique_lock<std::mutex> locker(mailbox->mutex);
+            std::deque<std::pair<std::shared_ptr<const Payload>, trace_point>>& pending = mailbox->pending;
+
+            // A delivery that threw leaves the mailbox unscheduled with its
+            // payloads, this emission then goes over the limit to post again
+            if (pending.size() >= mailbox->limit && mailbox->scheduled) {
+                switch (mailbox->overflow) {
+                case overflow_policy::block:
+                    // Gives up if the receiver or its thread dies meanwhile
+                    while (!mailbox->room.wait_for(locker, std::chrono::milliseconds(10), [&] { return pending.size() < mailbox->limit || !mailbox->scheduled; })) {
+                        if (!alive())
+                            return false;
+                    }
+                    break;
+                case overflow_policy::drop_newest:
+                    mailbox->dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                case overflow_policy::drop_oldest:
+                    pending.pop_front();
+                    mailbox->dropped.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                case overflow_policy::coalesce:
+                    pending.back() = {std::move(payload), trace};
+                    mailbox->dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            }
+
+            pending.emplace_back(std::move(payload), trace);
+            return !std::exchange(mailbox->scheduled, true);
+        }
+
+        // Runs on the receiver's thread, each payload traced as the call
+        // queued by its own emission
+        inline void deliver()
+        {
+            for (;;) {
+                std::pair<std::shared_ptr<const Payload>, trace_point> entry;
+                {
+                    std::lock_guard<std::mutex> locker(mailbox->mutex);
+
+                    if (mailbox->pending.empty()) {
+                        mailbox->scheduled = false;
+                        return;
+                    }
+
+                    entry = std::move(mailbox->pending.front());
+                    mailbox->pending.pop_front();
+                }
+
+                mailbox->room.notify_one();
+
+                // The payloads left are delivered by the next emission
+                try {
+                    const trace_scope scope(entry.second.id ? tracer::current() : nullptr, entry.second, true);
+                    call(*entry.first);
+                } catch (...) {
+                    {
+                        std::lock_guard<std::mutex> locker(mailbox->mutex);
+                        mailbox->scheduled = false;
+                    }
+                    mailbox->room.notify_all();
+                    throw;
+                }
+            }
+        }
+    };
+
+    // Slots are published as immutable snapshots, emit only reads a pointer
+    // to the current one while connect/disconnect copy, modify and swap it.
+    // Replaced snapshots are freed by snapshot_domain once the emissions
+    // iterating them ended. Snapshots are ordered by priority when connecting.
+    using Slots = std::vector<std::shared_ptr<Slot>>;
+
+    // Connection handles index into entries, freed indices are reused and
+    // their generation bumped so stale handles do not match the new slot
+    struct Entry {
+        std::shared_ptr<Slot> slot;
+        std::uint32_t generation = 0;
+    };
+
+    using Key = slot_key;
+
+    // Dead slots stay in the snapshot until a quarter of it is dead
+    static constexpr std::size_t compaction_ratio = 4;
+
+    // Coroutine suspended in co_await next(), resumed by the next emission.
+    // Shared with the queued resume, which does nothing once the awaiter was
+    // destroyed with its coroutine.
+    struct Waiter {
+        std::coroutine_handle<> handle;
+        Affinity affinity;
+        std::shared_ptr<const Payload> payload;
+        std::atomic<bool> cancelled{false};
+    };
+
+    struct Table : slot_table
+    {
+        std::atomic<std::shared_ptr<const Slots>> slots{std::make_shared<const Slots>()};
+        std::atomic<const Slots*> current{slots.load(std::memory_order_relaxed).get()};  // Read by emitters
+        std::atomic<bool> awaited{false};  // Whether waiters is not empty, read without locking
+        std::atomic<std::size_t> expired{0};  // Dead slots still in the snapshot, approximate
+        parallel_options parallel;  // Only used by signals without a result
+
+        // Signals without a result skip their slots while blocked, keeping
+        // the newest arguments to replay on unblock if deferring. blocked
+        // counts block() calls, with the deferring bit set by block(true),
+        // so emitters read both with a single load.
+        static constexpr std::uint32_t deferring = 1u << 31;
+        std::atomic<std::uint32_t> blocked{0};
+        std::mutex deferred_lock;
+        std::shared_ptr<const Payload> deferred;  // Guarded by deferred_lock
+        std::vector<Entry> entries;
+        std::vector<std::uint32_t> free;
+        std::mutex lock;
+        std::vector<std::shared_ptr<Waiter>> waiters;
+        std::mutex waiter_lock;
+
+        // Marks the slot disconnected, emitters skip it right away and it is
+        // dropped from the snapshot the next time one is published
+        inline void release(Key key)
+        {
+            if (!owns(key))
+                return;
+
+            Entry& entry = entries[key.index];
+
+            if (entry.slot->connected.exchange(false, std::memory_order_acq_rel))
+                expired.fetch_add(1, std::memory_order_relaxed);
+
+            entry.slot.reset();
+            ++entry.generation;
+            free.push_back(key.index);
+        }
+
+        inline bool owns(Key key) const
+        {
+            return key.index < entries.size() && entries[key.index].generation == key.generation && entries[key.index].slot;
+        }
+
+        // Publishes a copy of the snapshot without its dead slots, the ones
+        // whose receiver or thread was destroyed also give their index back
+        inline void publish(std::shared_ptr<Slot> added = nullptr)
+        {
+            const std::shared_ptr<const Slots> current = slots.load(std::memory_order_relaxed);
+            auto next = std::make_shared<Slots>();
+            next->reserve(current->size() + (added ? 1 : 0));
+
+            for (const std::shared_ptr<Slot>& slot : *current) {
+                if (slot->alive()) {
+                    next->push_back(slot);
+                } else if (entries[slot->index].slot == slot) {
+                    release(Key{slot->index, entries[slot->index].generation});
+                }
+            }
+
+            if (added) {
+                const auto position = std::upper_bound(next->begin(), next->end(), added, [](const std::shared_ptr<Slot>& a, const std::shared_ptr<Slot>& b) {
+                    return a->priority > b->priority;
+                });
+
+                next->insert(position, std::move(added));
+            }
+
+            counters.published(next->size());
+            store(std::move(next));
+            expired.store(0, std::memory_order_relaxed);
+        }
+
+        // The previous snapshot is retired after emitters stopped finding it
+        inline void store(std::shared_ptr<const Slots> next)
+        {
+            current.store(next.get(), std::memory_order_seq_cst);
+            snapshot_domain::instance().retire(slots.exchange(std::move(next), std::memory_order_acq_rel));
+        }
+
+        // Snapshot to iterate for one emission
+        inline snapshot_guard<Slots> snapshot() const
+        {
+            return snapshot_guard<Slots>(current);
+        }
+
+        inline bool needs_compaction(std::size_t size) const
+        {
+            return expired.load(std::memory_order_relaxed) * compaction_ratio >= size;
+        }
+
+        // Called by emitters after they found dead slots, compacts without
+        // waiting if another thread is already connecting or disconnecting
+        inline void prune(std::size_t found, std::size_t size)
+        {
+            expired.fetch_add(found, std::memory_order_relaxed);
+
+            if (needs_compaction(size) && lock.try_lock()) {
+                publish();
+                lock.unlock();
+            }
+        }
+
+        void disconnect(std::span<const Key> keys) override
+        {
+            const std::unique_lock<std::mutex> locker = counters.lock(lock);
+
+            for (const Key& key : keys)
+                release(key);
+
+            if (needs_compaction(slots.load(std::memory_order_relaxed)->size()))
+                publish();
+        }
+
+        bool connected(Key key) override
+        {
+            std::lock_guard<std::mutex> locker(lock);
+            return owns(key) && entries[key.index].slot->alive();
+        }
+
+        std::uint64_t dropped(Key key) override
+        {
+            std::lock_guard<std::mutex> locker(lock);
+
+            if (!owns(key) || !entries[key.index].slot->mailbox)
+                return 0;
+
+            return entries[key.index].slot->mailbox->dropped.load(std::memory_order_relaxed);
+        }
+    };
+
+    std::shared_ptr<Table> table = std::make_shared<Table>();
+
+    inline connection insert(Callback&& callee, Affinity affinity, const slot_options& options, const std::source_location& origin, const std::shared_ptr<slot_table>& forward = nullptr)
+    {
+        auto slot = std::make_shared<Slot>(std::move(callee), std::move(affinity), options, origin, forward);
+
+        const std::unique_lock<std::mutex> locker = table->counters.lock(table->lock);
+        slot->signal.store(table->name.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        std::uint32_t index = static_cast<std::uint32_t>(table->entries.size());
+
+        if (table->free.empty()) {
+            table->entries.emplace_back();
+        } else {
+            index = table->free.back();
+            table->free.pop_back();
+        }
+
+        slot->index = index;
+        table->entries[index].slot = slot;
+        table->publish(std::move(slot));
+
+        return connection(table, Key{index, table->entries[index].generation});
+    }
+
+    // Empty when the receiver or its thread was destroyed, the slot is then
+    // marked so the next compaction drops it
+    static inline auto resolve(Slot& slot, std::size_t& dead)
+    {
+        const auto target = Executor::resolve(slot.affinity);
+
+        if (!target && !slot.detached && slot.connected.exchange(false, std::memory_order_acq_rel))
+            ++dead;
+
+        return target;
+    }
+
+    // Queues a call of the slot on its thread or pool. Disconnecting before
+    // the call ran cancels it, bounded slots go through their mailbox.
+    template <typename Target>
+    static inline void post(const Target& target, const std::shared_ptr<Slot>& slot, std::shared_ptr<const Payload> payload, const trace_point& trace = {})
+    {
+        if (!slot->mailbox)
+            slot->schedule(target, [slot, payload = std::move(payload)] { slot->call(*payload); }, trace);
+        else if (slot->enqueue(std::move(payload), trace))
+            slot->schedule(target, [slot] { slot->deliver(); });
+    }
+
+public:
+    // Connections, queued calls and forwarding slots refer to the slot table,
+    // a copy would share it and a moved-from signal would have none
+    signal_base() = default;
+    signal_base(const signal_base&) = delete;
+    signal_base& operator=(const signal_base&) = delete;
+
+    // Support function pointers and lamdas
+    template <typename Function>
+    requires std::is_invocable_r_v<R, Function, slot_parameter<Args>...>
+    connection connect(Function&& callee, const slot_options& options = {}, const std::source_location& origin = std::source_location::current())
+    {
+        return insert(Callback(std::forward<Function>(callee)), Executor::current(), options, origin);
+    }
+
+    // Support member functions with different reference types
+    template <typename ClassType, typename Function>
+    requires std::is_invocable_r_v<R, Function, ClassType*, slot_parameter<Args>...>
+    connection connect(ClassType* instance, Function&& member_function, const slot_options& options = {}, const std::source_location& origin = std::source_location::current())
+    {
+        return insert(Callback(instance, std::forward<Function>(member_function)), Executor::of(instance), options, origin);
+    }
+
+    void disconnect()
+    {
+        const std::unique_lock<std::mutex> locker = table->counters.lock(table->lock);
+
+        for (std::uint32_t index = 0; index < table->entries.size(); ++index)
+            table->release(Key{index, table->entries[index].generation});
+
+        table->store(std::make_shared<const Slots>());
+        table->expired.store(0, std::memory_order_relaxed);
+    }
+
+    // Name reported by stats(), melo::signal_registry, the tracer and the
+    // watchdog, also for slots already connected. Not copied.
+    void set_name(const char* name)
+    {
+        const std::unique_lock<std::mutex> locker = table->counters.lock(table->lock);
+        table->name.store(name, std::memory_order_relaxed);
+
+        for (const Entry& entry : table->entries) {
+            if (entry.slot)
+                entry.slot->signal.store(name, std::memory_order_relaxed);
+        }
+    }
+
+    // All zero unless MELO_SIGNAL_STATS is 1
+    signal_stats stats() const
+    {
+        return table->stats();
+    }
+
+    // Number of connected slots whose receiver and thread are still alive
+    std::size_t slot_count() const
+    {
+        const std::shared_ptr<const Slots> snapshot = table->slots.load(std::memory_order_acquire);
+        return std::count_if(snapshot->begin(), snapshot->end(), [](const std::shared_ptr<Slot>& slot) { return slot->alive(); });
+    }
+
+    // Number of disconnected or dead slots waiting to be compacted away
+    std::size_t dead_count() const
+    {
+        const std::shared_ptr<const Slots> snapshot = table->slots.load(std::memory_order_acquire);
+        return snapshot->size() - std::count_if(snapshot->begin(), snapshot->end(), [](const std::shared_ptr<Slot>& slot) { return slot->alive(); });
+    }
+};
+
+} // namespace detail
+
+template <executor Executor, typename... Args>
+class basic_signal : public detail::signal_base<Executor, void, Args...>
+{
+private:
+    using Base = detail::signal_base<Executor, void, Args...>;
+    using typename Base::Affinity;
+    using typename Base::Payload;
+    using typename Base::Slot;
+    using typename Base::Slots;
+    using typename Base::Table;
+    using typename Base::Waiter;
+    using Base::table;
+    using Base::insert;
+    using Base::resolve;
+    using Base::post;
+
+    // Resumes the coroutines waiting for an emission, each in its own thread.
+    // One resumed here may destroy another, which is then skipped.
+    static inline void wake(Table& table, const std::shared_ptr<const Payload>& payload)
+    {
+        std::vector<std::shared_ptr<Waiter>> waiters;
+        {
+            std::lock_guard<std::mutex> locker(table.waiter_lock);
+            waiters.swap(table.waiters);
+            table.awaited.store(false, std::memory_order_relaxed);
+        }
+
+        for (const std::shared_ptr<Waiter>& waiter : waiters) {
+            const auto target = Executor::resolve(waiter->affinity);
+
+            waiter->payload = payload;
+
+            // A coroutine whose thread is gone can not be resumed anywhere
+            if (!target)
+                continue;
+
+            if (Executor::is_current(target)) {
+                if (!waiter->cancelled.load(std::memory_order_acquire))
+                    waiter->handle.resume();
+            } else {
+                Executor::post(target, [waiter] {
+                    if (!waiter->cancelled.load(std::memory_order_acquire))
+                        waiter->handle.resume();
+                });
+            }
+        }
+    }
+
+    // Calls the slots of the table, the payload for queued calls is made on
+    // the first one unless given. Forwarding slots dispatch to the other
+    // signal's slots in place, sharing the payload.
+    static inline void dispatch(Table& table, std::shared_ptr<const Payload>& payload, detail::slot_parameter<Args>... args)
+    {
+        if (const std::uint32_t blocked = table.blocked.load(std::memory_order_relaxed)) {
+            if (blocked & Table::deferring)
+                defer(table, payload ? payload : std::make_shared<const Payload>(args...));
+
+            return;
+        }
+
+        tracer* const tracing = tracer::current();
+        const detail::trace_point trace = tracing ? detail::trace_point{table.name.load(std::memory_order_relaxed), tracer::next_emission()} : detail::trace_point{};
+        const detail::trace_scope scope(tracing, trace, false);
+
+        const detail::snapshot_guard<Slots> snapshot = table.snapshot();
+        const parallel_options& parallel = table.parallel;
+        const bool partitioned = parallel.pool && !parallel.deterministic && snapshot->size() >= parallel.threshold && partitions(parallel) > 1;
+        std::vector<Slot*> direct;
+        std::size_t dead = 0;
+        std::size_t called = 0, queued = 0, skipped = 0;  // Only read with MELO_SIGNAL_STATS
+
+        for (const std::shared_ptr<Slot> &slot : *snapshot)
+        {
+            if(!slot->connected.load(std::memory_order_acquire))
+            {
+                ++skipped;
+                continue;
+            }
+
+            const auto target = resolve(*slot, dead);
+
+            if((!target && !slot->detached) || !slot->callback)
+            {
+                ++skipped;
+                continue;
+            }
+
+            const bool here = slot->runs_here(target);
+            const detail::trace_point hop = tracing && !here ? detail::trace_point{trace.signal, trace.id, tracer::next_flow()} : trace;
+
+            if (tracing)
+                tracing->slot_dispatched(hop.signal, hop.id, hop.flow);
+
+            if(here)
+            {
+                ++called;
+
+                if (slot->forwards)
+                    forward(table, *slot, dead, payload, args...);
+                else if (partitioned)
+                    direct.push_back(slot.get());
+                else
+                    slot->invoke(false, args...);
+            }
+            else
+            {
+                if (!payload)
+                    payload = std::make_shared<const Payload>(args...);
+
+                ++queued;
+                post(target, slot, payload, hop);
+            }
+        }
+
+        table.counters.emitted(1, called, queued, skipped);
+
+        if (!direct.empty())
+            fan_out(parallel, std::move(direct), args...);
+
+        if (table.awaited.load(std::memory_order_acquire)) {
+            if (!payload)
+                payload = std::make_shared<const Payload>(args...);
+
+            wake(table, payload);
+        }
+
+        if (dead)
+            table.prune(dead, snapshot->size());
+    }
+
+    // Keeps the newest emission skipped while deferring. unblock() takes the
+    // payload under the same lock it unblocks with, so an emitter that found
+    // the signal blocked just before unblock() dispatches the payload itself
+    // instead of leaving it behind.
+    static inline void defer(Table& table, std::shared_ptr<const Payload> payload)
+    {
+        {
+            std::lock_guard<std::mutex> locker(table.deferred_lock);
+
+            if (table.blocked.load(std::memory_order_relaxed) & Table::deferring) {
+                table.deferred = std::move(payload);
+                return;
+            }
+        }
+
+        replay(table, std::move(payload));
+    }
+
+    static inline void replay(Table& table, std::shared_ptr<const Payload> payload)
+    {
+        std::apply([&](const auto&... args) { dispatch(table, payload, args...); }, *payload);
+    }
+
+    // Dispatches to the signal a slot forwards to, a slot whose signal was
+    // destroyed is counted dead. A signal already being dispatched along the
+    // chain of forwards is skipped, so a cycle calls each slot once.
+    static inline void forward(const Table& from, Slot& slot, std::size_t& dead, std::shared_ptr<const Payload>& payload, detail::slot_parameter<Args>... args)
+    {
+        // Signals of the forwarding chains the thread is walking, a slot
+        // emitting a signal itself starts a new chain at the end
+        thread_local std::vector<const detail::slot_table*> chain;
+        thread_local std::size_t start = 0;
+
+        const std::shared_ptr<detail::slot_table> other = slot.forward.lock();
+
+        if (!other) {
+            if (slot.connected.exchange(false, std::memory_order_acq_rel))
+                ++dead;
+
+            return;
+        }
+
+        struct Link {
+            const std::size_t outer = start;
+            const bool root;
+
+            explicit Link(const detail::slot_table* from) : root(chain.size() == start || chain.back() != from)
+            {
+                if (root) {
+                    start = chain.size();
+                    chain.push_back(from);
+                }
+            }
+
+            ~Link()
+            {
+                if (root) {
+                    chain.pop_back();
+                    start = outer;
+                }
+            }
+        } link(&from);
+
+        if (std::find(chain.begin() + start, chain.end(), other.get()) != chain.end())
+            return;
+
+        chain.push_back(other.get());
+
+        struct Pop {
+            ~Pop() { chain.pop_back(); }
+        } pop;
+
+        dispatch(static_cast<Table&>(*other), payload, args...);
+    }
+
+    // Number of partitions asked for, one per core by default
+    static inline std::size_t partitions(const parallel_options& parallel)
+    {
+        return parallel.partitions ? parallel.partitions : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Calls the direct slots split in partitions, taken in turn by the pool's
+    // threads and the emitting one. Returns once they all returned, rethrowing
+    // the first exception thrown by a slot.
+    static inline void fan_out(const parallel_options& parallel, std::vector<Slot*>&& slots, detail::slot_parameter<Args>... args)
+    {
+        const std::size_t partitions = std::min(slots.size(), basic_signal::partitions(parallel));
+
+        if (partitions < 2) {
+            for (const Slot* slot : slots)
+                slot->invoke(false, args...);
+
+            return;
+        }
+
+        // Tasks running after all partitions were taken do not touch the
+        // arguments, which live on the emitter's stack
+        struct Work {
+            const std::vector<Slot*> slots;
+            const std::tuple<detail::slot_parameter<Args>...> args;
+            const std::size_t partitions;
+            std::atomic<std::size_t> next{0};
+            std::atomic<std::size_t> done{0};
+            std::mutex mutex;
+            std::exception_ptr error;
+
+            Work(std::vector<Slot*>&& slots, detail::slot_parameter<Args>... args, std::size_t partitions)
+                : slots(std::move(slots)), args{args...}, partitions(partitions) {}
+
+            // Returns false once every partition was taken
+            bool run()
+            {
+                const std::size_t partition = next.fetch_add(1, std::memory_order_relaxed);
+
+                if (partition >= partitions)
+                    return false;
+
+                const std::size_t end = slots.size() * (partition + 1) / partitions;
+
+                try {
+                    for (std::size_t i = slots.size() * partition / partitions; i < end; ++i)
+                        std::apply([&](auto&&... values) { slots[i]->invoke(false, std::forward<decltype(values)>(values)...); }, args);
+                } catch (...) {
+                    std::lock_guard<std::mutex> locker(mutex);
+
+                    if (!error)
+                        error = std::current_exception();
+                }
+
+                if (done.fetch_add(1, std::memory_order_acq_rel) + 1 == partitions)
+                    done.notify_all();
+
+                return true;
+            }
+        };
+
+        const auto work = std::make_shared<Work>(std::move(slots), args..., partitions);
+
+        for (std::size_t i = 1; i < partitions; ++i)
+            parallel.pool->post([work] { work->run(); });
+
+        while (work->run()) {}
+
+        for (std::size_t done; (done = work->done.load(std::memory_order_acquire)) < partitions;)
+            work->done.wait(done, std::memory_order_acquire);
+
+        if (work->error)
+            std::rethrow_exception(work->error);
+    }
+
+public:
+    // Awaitable returned by next(), no slot is connected for it. Destroying
+    // the suspended coroutine withdraws it, a resume already queued to its
+    // thread then does nothing.
+    class next_awaiter
+    {
+    private:
+        std::shared_ptr<Table> table;
+        std::shared_ptr<Waiter> waiter;
+
+    public:
+        explicit next_awaiter(std::shared_ptr<Table> table) : table(std::move(table)) {}
+
+        next_awaiter(const next_awaiter&) = delete;
+        next_awaiter& operator=(const next_awaiter&) = delete;
+
+        ~next_awaiter()
+        {
+            if (!waiter)
+                return;
+
+            waiter->cancelled.store(true, std::memory_order_release);
+
+            std::lock_guard<std::mutex> locker(table->waiter_lock);
+            std::erase(table->waiters, waiter);
+            table->awaited.store(!table->waiters.empty(), std::memory_order_relaxed);
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            waiter = std::make_shared<Waiter>();
+            waiter->handle = handle;
+            waiter->affinity = Executor::current();
+
+            std::lock_guard<std::mutex> locker(table->waiter_lock);
+            table->waiters.push_back(waiter);
+            table->awaited.store(true, std::memory_order_release);
+        }
+
+        Payload await_resume() const { return *waiter->payload; }
+    };
+
+    ~basic_signal() = default;
+    basic_signal() = default;
+
+    using Base::connect;
+
+    // Once the signal has at least options.threshold slots, the ones called
+    // directly by emit() and emit_async() are split across the pool's threads
+    // and the emitting one, which waits for all of them. Their order is then
+    // unspecified, priorities included, and they run after the queued calls
+    // were posted and the forwarded signals emitted. Not synchronized with
+    // emit(), set it before emitting from other threads.
+    void set_parallel(const parallel_options& options)
+    {
+        table->parallel = options;
+    }
+
+    // Emits skip the slots until unblock() was called as many times as
+    // block(). With deferred, the newest emission skipped is replayed once
+    // the signal is unblocked, the others are dropped.
+    void block(bool deferred = false)
+    {
+        std::uint32_t blocked = table->blocked.load(std::memory_order_relaxed);
+
+        // The count and the deferring bit change together, the bit is never
+        // set on an unblocked signal
+        while (!table->blocked.compare_exchange_weak(blocked, (blocked + 1) | (deferred ? Table::deferring : 0), std::memory_order_relaxed))
+            ;
+    }
+
+    // Extra calls leave the signal unblocked
+    void unblock()
+    {
+        std::shared_ptr<const Payload> payload;
+        {
+            std::lock_guard<std::mutex> locker(table->deferred_lock);
+            std::uint32_t blocked = table->blocked.load(std::memory_order_relaxed);
+            std::uint32_t next;
+
+            do {
+                if ((blocked & ~Table::deferring) == 0)
+                    return;
+
+                next = (blocked & ~Table::deferring) == 1 ? 0 : blocked - 1;
+            } while (!table->blocked.compare_exchange_weak(blocked, next, std::memory_order_relaxed));
+
+            if (next == 0)
+                payload = std::move(table->deferred);
+        }
+
+        if (payload)
+            replay(*table, std::move(payload));
+    }
+
+    bool blocked() const noexcept
+    {
+        return (table->blocked.load(std::memory_order_relaxed) & ~Table::deferring) != 0;
+    }
+
+    // co_await sig.next() suspends the coroutine until the next emission and
+    // returns its arguments. The coroutine is resumed in the thread it was
+    // suspended from, or never if that thread is gone or the signal destroyed.
+    // It may be destroyed while suspended, but only from that same thread.
+    next_awaiter next() const
+    {
+        return next_awaiter(table);
+    }
+
+    // Support connecting one signal to another. Emitting this signal from
+    // the connecting thread calls the other signal's slots in the same pass,
+    // else the forwarding is queued to that thread like a slot. The connection
+    // dies with the other signal.
+    template <typename OtherSignal>
+    requires std::same_as<OtherSignal, basic_signal>
+    connection connect(OtherSignal &other, const slot_options& options = {}, const std::source_location& origin = std::source_location::current())
+    {
+        // Only called for queued, pooled and batched forwarding
+        const auto callee = [table = std::weak_ptr<Table>(other.table)](detail::slot_parameter<Args>... args) {
+            if (const std::shared_ptr<Table> other = table.lock()) {
+                std::shared_ptr<const Payload> payload;
+                dispatch(*other, payload, args...);
+            }
+        };
+
+        return insert(callee, Executor::current(), options, origin, other.table);
+    }
+
+    void emit(Args... args)
+    {
+        std::shared_ptr<const Payload> payload;
+        dispatch(*table, payload, args...);
+    }
+
+    // Same as emit(), the returned emission completes once every slot called
+    // for it returned, including the queued ones
+    emission emit_async(Args... args)
+    {
+        auto done = std::make_shared<std::atomic<bool>>(false);
+
+        // Queued calls share the payload, it is destroyed after the last one
+        std::shared_ptr<const Payload> payload(new Payload(args...), [done](const Payload* payload) {
+            delete payload;
+            done->store(true, std::memory_order_release);
+            done->notify_all();
+        });
+
+        dispatch(*table, payload, args...);
+        return emission(std::move(done));
+    }
+
+    // Emits once per tuple of arguments in the range. The slots are looked up
+    // once, direct slots are called in a tight loop and each receiving thread
+    // gets a single queued call running its slots over the whole batch.
+    template <std::ranges::input_range Range>
+    requires std::constructible_from<Payload, std::ranges::range_reference_t<Range>>
+    void emit_batch(Range&& range)
+    {
+        if (const std::uint32_t blocked = table->blocked.load(std::memory_order_relaxed)) {
+            if (blocked & Table::deferring) {
+                std::optional<Payload> last;
+
+                for (auto&& element : range)
+                    last.emplace(std::forward<decltype(element)>(element));
+
+                if (last)
+                    defer(*table, std::make_shared<const Payload>(std::move(*last)));
+            }
+
+            return;
+        }
+
+        using Target = decltype(Executor::resolve(std::declval<const Affinity&>()));
+        using Thread = decltype(Executor::thread(std::declval<const Target&>()));
+
+        struct Group {
+            Thread thread;
+            Target target;
+            std::vector<std::shared_ptr<Slot>> slots;
+        };
+
+        const detail::snapshot_guard<Slots> snapshot = table->snapshot();
+        std::vector<Slot*> direct;
+        std::vector<Group> queued;
+        std::vector<std::shared_ptr<Slot>> detached;
+        std::size_t dead = 0;
+        std::size_t count = 0, pending = 0, skipped = 0;  // Only read with MELO_SIGNAL_STATS
+
+        for (const std::shared_ptr<Slot> &slot : *snapshot)
+        {
+            if(!slot->connected.load(std::memory_order_acquire))
+            {
+                ++skipped;
+                continue;
+            }
+
+            const auto target = resolve(*slot, dead);
+
+            if((!target && !slot->detached) || !slot->callback)
+            {
+                ++skipped;
+                continue;
+            }
+
+            if(slot->runs_here(target))
+            {
+                direct.push_back(slot.get());
+                continue;
+            }
+
+            ++pending;
+
+            // Posted to their pool, possibly with the thread they were
+            // connected from gone
+            if (slot->detached)
+            {
+                detached.push_back(slot);
+                continue;
+            }
+
+            const Thread thread = Executor::thread(target);
+            auto group = std::find_if(queued.begin(), queued.end(), [&](const Group& other) { return other.thread == thread; });
+
+            if (group == queued.end())
+                group = queued.insert(queued.end(), Group{thread, target, {}});
+
+            group->slots.push_back(slot);
+        }
+
+        // Coroutines waiting in next() get the first element
+        if (queued.empty() && detached.empty() && !table->awaited.load(std::memory_order_acquire))
+        {
+            for (auto&& element : range) {
+                const Payload args(std::forward<decltype(element)>(element));
+
+                for (const Slot* slot : direct)
+                    slot->call(args, false);
+
+                ++count;
+            }
+        }
+        else
+        {
+            const auto batch = std::make_shared<const std::vector<Payload>>(std::ranges::begin(range), std::ranges::end(range));
+            count = batch->size();
+
+            for (const Payload& args : *batch) {
+                for (const Slot* slot : direct)
+                    slot->call(args, false);
+            }
+
+            if (batch->empty())
+                queued.clear();
+            else if (table->awaited.load(std::memory_order_acquire))
+                wake(*table, std::shared_ptr<const Payload>(batch, &batch->front()));
+
+            for (const std::shared_ptr<Slot>& slot : detached) {
+                for (const Payload& args : *batch)
+                    post(Target{}, slot, std::shared_ptr<const Payload>(batch, &args));
+            }
+
+            for (Group& group : queued) {
+                std::vector<std::shared_ptr<Slot>> slots;
+
+                // Bounded and pooled slots get each element on its own
+                for (std::shared_ptr<Slot>& slot : group.slots) {
+                    if (!slot->mailbox && !slot->pool) {
+                        slots.push_back(std::move(slot));
+                        continue;
+                    }
+
+                    for (const Payload& args : *batch)
+                        post(group.target, slot, std::shared_ptr<const Payload>(batch, &args));
+                }
+
+                if (slots.empty())
+                    continue;
+
+                Executor::post(group.target, [slots = std::move(slots), batch] {
+                    for (const Payload& args : *batch) {
+                        for (const std::shared_ptr<Slot>& slot : slots)
+                            slot->call(args);
+                    }
+                });
+            }
+        }
+
+        table->counters.emitted(count, direct.size() * count, pending * count, skipped);
+
+        if (dead)
+            table->prune(dead, snapshot->size());
+    }
+};
+
+// Blocks a signal for its lifetime, like QSignalBlocker
+template <typename Signal>
+class signal_blocker
+{
+private:
+    Signal& signal;
+
+public:
+    explicit signal_blocker(Signal& signal, bool deferred = false) : signal(signal)
+    {
+        signal.block(deferred);
+    }
+
+    ~signal_blocker()
+    {
+        signal.unblock();
+    }
+
+    signal_blocker(const signal_blocker&) = delete;
+    signal_blocker& operator=(const signal_blocker&) = delete;
+};
+
+// Combiners aggregate the values returned by the slots of a result signal,
+// basic_signal<Executor, R(Args...), Combiner>. They get input iterators over
+// the results and a slot is only called when the iterator pointing to it is
+// dereferenced, so a combiner returning early skips the remaining slots.
+
+// Value returned by the last slot, empty without slots
+template <typename T>
+struct last
+{
+    template <std::input_iterator It>
+    std::optional<T> operator()(It first, It end) const
+    {
+        std::optional<T> result;
+
+        for (; first != end; ++first)
+            result.emplace(*first);
+
+        return result;
+    }
+};
+
+template <typename T>
+struct sum
+{
+    template <std::input_iterator It>
+    T operator()(It first, It end) const
+    {
+        T result{};
+
+        for (; first != end; ++first)
+            result = result + *first;
+
+        return result;
+    }
+};
+
+// Values returned by all the slots, in order
+template <typename T>
+struct collect
+{
+    template <std::input_iterator It>
+    std::vector<T> operator()(It first, It end) const
+    {
+        std::vector<T> result;
+
+        for (; first != end; ++first)
+            result.push_back(*first);
+
+        return result;
+    }
+};
+
+// First value that is true when converted to bool (non-null pointer, engaged
+// optional...), or a value-initialized T
+template <typename T>
+struct first_non_null
+{
+    template <std::input_iterator It>
+    T operator()(It first, It end) const
+    {
+        for (; first != end; ++first) {
+            if (const T& value = *first)
+                return value;
+        }
+
+        return T{};
+    }
+};
+
+// First value matching the predicate, the remaining slots are not called
+template <typename T, typename Predicate>
+struct until
+{
+    [[no_unique_address]] Predicate predicate{};
+
+    template <std::input_iterator It>
+    std::optional<T> operator()(It first, It end) const
+    {
+        for (; first != end; ++first) {
+            if (const T& value = *first; predicate(value))
+                return value;
+        }
+
+        return std::nullopt;
+    }
+};
+
+// Signal whose slots return values, aggregated by the combiner into the value
+// returned by emit(). Queued slots contribute through a future: the emitting
+// thread waits until the slot ran on its own thread, emit() rethrowing the
+// exception of a slot, or std::future_error if a queued slot was destroyed
+// before it could run. Since at most one call per slot is ever queued,
+// conflate and queue_limit do not apply, and result signals have no block()
+// nor set_parallel().
+template <executor Executor, typename R, typename... Args, typename Combiner>
+class basic_signal<Executor, R(Args...), Combiner> : public detail::signal_base<Executor, R, Args...>
+{
+private:
+    static_assert(std::is_object_v<R>, "slots of a result signal must return an object type");
+
+    using Base = detail::signal_base<Executor, R, Args...>;
+    using typename Base::Affinity;
+    using typename Base::Payload;
+    using typename Base::Slot;
+    using typename Base::Slots;
+    using Base::table;
+    using Base::resolve;
+
+    using Target = decltype(Executor::resolve(std::declval<const Affinity&>()));
+
+    // State shared by the iterators of one emission
+    struct Emission {
+        std::tuple<detail::slot_parameter<Args>...> args;
+        std::shared_ptr<const Payload> payload;  // Copy of the arguments for queued slots
+        std::size_t dead = 0;
+        std::size_t called = 0, queued = 0, skipped = 0;  // Only read with MELO_SIGNAL_STATS
+    };
+
+    [[no_unique_address]] Combiner combiner{};
+
+public:
+    class result_iterator
+    {
+    private:
+        const std::shared_ptr<Slot>* slot = nullptr;
+        const std::shared_ptr<Slot>* end = nullptr;
+        Emission* emission = nullptr;
+        Target target{};
+        mutable std::optional<R> value;
+
+        // Skips disconnected and dead slots
+        inline void settle()
+        {
+            for (; slot != end; ++slot) {
+                if ((*slot)->connected.load(std::memory_order_acquire) && (*slot)->callback && ((target = basic_signal::resolve(**slot, emission->dead)) || (*slot)->detached))
+                    return;
+
+                ++emission->skipped;
+            }
+        }
+
+        inline R call() const
+        {
+            const Slot& current = **slot;
+
+            if (current.runs_here(target)) {
+                ++emission->called;
+                return std::apply([&](auto&&... values) { return current.invoke(false, std::forward<decltype(values)>(values)...); }, emission->args);
+            }
+
+            ++emission->queued;
+
+            if (!emission->payload)
+                emission->payload = std::make_shared<const Payload>(emission->args);
+
+            auto promise = std::make_shared<std::promise<R>>();
+            std::future<R> future = promise->get_future();
+
+            current.schedule(target, [slot = *slot, payload = emission->payload, promise] {
+                if (!slot->connected.load(std::memory_order_acquire))
+                    return;
+
+                try {
+                    promise->set_value(std::apply([&](const auto&... values) { return slot->invoke(true, values...); }, *payload));
+                } catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            });
+
+            return future.get();
+        }
+
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = R;
+        using difference_type = std::ptrdiff_t;
+        using reference = const R&;
+
+        result_iterator() = default;
+        result_iterator(const std::shared_ptr<Slot>* slot, const std::shared_ptr<Slot>* end, Emission* emission)
+            : slot(slot), end(end), emission(emission)
+        {
+            settle();
+        }
+
+        const R& operator*() const
+        {
+            if (!value)
+                value.emplace(call());
+
+            return *value;
+        }
+
+        result_iterator& operator++()
+        {
+            ++slot;
+            value.reset();
+            settle();
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const result_iterator& a, const result_iterator& b) { return a.slot == b.slot; }
+    };
+
+    ~basic_signal() = default;
+    basic_signal() = default;
+    explicit basic_signal(Combiner combiner) : combiner(std::move(combiner)) {}
+
+    auto emit(Args... args)
+    {
+        const detail::snapshot_guard<Slots> snapshot = table->snapshot();
+        const std::shared_ptr<Slot>* first = snapshot->data();
+        const std::shared_ptr<Slot>* end = first + snapshot->size();
+        Emission emission{{args...}, nullptr};
+
+        auto result = combiner(result_iterator(first, end, &emission), result_iterator(end, end, &emission));
+        table->counters.emitted(1, emission.called, emission.queued, emission.skipped);
+
+        if (emission.dead)
+            table->prune(emission.dead, snapshot->size());
+
+        return result;
+    }
+};
+
+// Result signal combining with melo::last by default
+template <executor Executor, typename R, typename... Args>
+class basic_signal<Executor, R(Args...)> : public basic_signal<Executor, R(Args...), last<R>>
+{
+};
+
+// Std-only task queue owned by one thread, the counterpart of a Qt event loop
+// for threads that do not run one. Tasks posted to it run when its thread
+// calls run() or process_events().
+class event_loop
+{
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<delegate<void()>> tasks;
+    std::thread::id owner = std::this_thread::get_id();
+    bool stopped = false;
+
+public:
+    // Loop of the calling thread, destroyed when the thread exits
+    static const std::shared_ptr<event_loop>& current()
+    {
+        thread_local const std::shared_ptr<event_loop> loop = std::make_shared<event_loop>();
+        return loop;
+    }
+
+    std::thread::id thread_id() const noexcept { return owner; }
+
+    void post(delegate<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> locker(mutex);
+            tasks.push_back(std::move(task));
+        }
+        ready.notify_one();
+    }
+
+    // Runs the tasks already queued and returns how many ran
+    std::size_t process_events()
+    {
+        std::deque<delegate<void()>> pending;
+        {
+            std::lock_guard<std::mutex> locker(mutex);
+            pending.swap(tasks);
+        }
+
+        for (const delegate<void()>& task : pending)
+            task();
+
+        return pending.size();
+    }
+
+    // Runs tasks as they are posted until quit() is called
+    void run()
+    {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> locker(mutex);
+                ready.wait(locker, [this] { return stopped || !tasks.empty(); });
+
+                if (stopped && tasks.empty()) {
+                    stopped = false;
+                    return;
+                }
+            }
+
+            process_events();
+        }
+    }
+
+    void quit()
+    {
+        {
+            std::lock_guard<std::mutex> locker(mutex);
+            stopped = true;
+        }
+        ready.notify_one();
+    }
+};
+
+// Executor for threads running a melo::event_loop, slots are bound to the
+// loop of the thread they were connected from
+struct thread_executor
+{
+    struct affinity {
+        std::weak_ptr<event_loop> loop;
+        std::thread::id thread;
+    };
+
+    static affinity current()
+    {
+        const std::shared_ptr<event_loop>& loop = event_loop::current();
+        return {loop, loop->thread_id()};
+    }
+
+    template <typename T>
+    static affinity of(T*)
+    {
+        return current();
+    }
+
+    static const affinity* resolve(const affinity& target)
+    {
+        return target.loop.expired() ? nullptr : &target;
+    }
+
+    static bool is_current(const affinity* target)
+    {
+        return target->thread == std::this_thread::get_id();
+    }
+
+    static std::thread::id thread(const affinity* target)
+    {
+        return target->thread;
+    }
+
+    template <typename Task>
+    static void post(const affinity* target, Task&& task)
+    {
+        if (const std::shared_ptr<event_loop> loop = target->loop.lock())
+            loop->post(std::forward<Task>(task));
+    }
+};
+
+// Bounded lock-free queue of tasks with many producers and a single consumer,
+// the thread owning it. Producers never lock, the owner drains the queue from
+// run(), or from its own event loop with drain() and a wakeup callback. The
+// queue of a thread is closed when the thread exits, posts then fail.
+class dispatch_queue
+{
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        delegate<void()> task;
+    };
+
+    const std::size_t mask;
+    const std::unique_ptr<Cell[]> cells;
+    const std::thread::id owner = std::this_thread::get_id();
+    std::atomic<std::shared_ptr<const delegate<void()>>> wakeup;
+
+    alignas(64) std::atomic<std::size_t> tail{0};
+    alignas(64) std::size_t head = 0;
+    std::atomic<bool> notified{false};
+    std::atomic<bool> stopped{false};
+    std::atomic<bool> closed{false};
+
+public:
+    explicit dispatch_queue(std::size_t capacity = MELO_DISPATCH_QUEUE_SIZE)
+        : mask(capacity - 1), cells(new Cell[capacity])
+    {
+        for (std::size_t i = 0; i < capacity; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // Queue of the calling thread, closed when the thread exits. Producers
+    // still holding it then stop waiting for room.
+    static const std::shared_ptr<dispatch_queue>& current()
+    {
+        struct Owner {
+            const std::shared_ptr<dispatch_queue> queue = std::make_shared<dispatch_queue>();
+            ~Owner() { queue->close(); }
+        };
+
+        thread_local const Owner owner;
+        return owner.queue;
+    }
+
+    std::thread::id thread_id() const noexcept { return owner; }
+
+    // Called by the first post after the queue was drained, so an event loop
+    // can wake up and drain it. Producers may be posting while it is set.
+    void set_wakeup(delegate<void()> callback)
+    {
+        wakeup.store(std::make_shared<const delegate<void()>>(std::move(callback)), std::memory_order_release);
+    }
+
+    // Returns false without waiting if the queue is full or closed
+    bool try_post(delegate<void()>&& task)
+    {
+        if (closed.load(std::memory_order_acquire))
+            return false;
+
+        std::size_t position = tail.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        for (;;) {
+            cell = &cells[position & mask];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+            if (difference == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        // Sequentially consistent with drain(), so either the owner sees this
+        // task or this post sees the queue drained and wakes the owner up
+        cell->task = std::move(task);
+        cell->sequence.store(position + 1, std::memory_order_seq_cst);
+
+        if (!notified.exchange(true, std::memory_order_seq_cst)) {
+            notified.notify_one();
+
+            if (const std::shared_ptr<const delegate<void()>> callback = wakeup.load(std::memory_order_acquire); callback && *callback)
+                (*callback)();
+        }
+
+        return true;
+    }
+
+    // Waits for the owner to make room when the queue is full, returns false
+    // and drops the task if the queue is or gets closed meanwhile
+    bool post(delegate<void()> task)
+    {
+        while (!try_post(std::move(task))) {
+            if (closed.load(std::memory_order_acquire))
+                return false;
+
+            if (std::this_thread::get_id() == owner)
+                drain();
+            else
+                std::this_thread::yield();
+        }
+
+        return true;
+    }
+
+    // Runs the queued tasks on the owning thread and returns how many ran
+    std::size_t drain()
+    {
+        notified.store(false, std::memory_order_seq_cst);
+        std::size_t count = 0;
+
+        for (;; ++count) {
+            Cell& cell = cells[head & mask];
+
+            if (cell.sequence.load(std::memory_order_seq_cst) != head + 1)
+                return count;
+
+            const delegate<void()> task = std::move(cell.task);
+            cell.sequence.store(head + mask + 1, std::memory_order_release);
+            ++head;
+
+            task();
+        }
+    }
+
+    // Plain loop draining the queue until quit() is called
+    void run()
+    {
+        for (;;) {
+            drain();
+
+            if (stopped.exchange(false))
+                return;
+
+            notified.wait(false, std::memory_order_acquire);
+        }
+    }
+
+    void quit()
+    {
+        stopped.store(true);
+        notified.store(true);
+        notified.notify_one();
+    }
+
+    // Rejects later posts, tasks already queued are dropped unless drained
+    void close() noexcept
+    {
+        closed.store(true, std::memory_order_release);
+    }
+
+    bool is_closed() const noexcept { return closed.load(std::memory_order_acquire); }
+};
+
+// Executor queuing calls to the melo::dispatch_queue of the thread slots were
+// connected from, instead of going through an event loop's own queue
+struct queue_executor
+{
+    struct affinity {
+        std::weak_ptr<dispatch_queue> queue;
+        std::thread::id thread;
+    };
+
+    static affinity current()
+    {
+        const std::shared_ptr<dispatch_queue>& queue = dispatch_queue::current();
+        return {queue, queue->thread_id()};
+    }
+
+    template <typename T>
+    static affinity of(T*)
+    {
+        return current();
+    }
+
+    static const affinity* resolve(const affinity& target)
+    {
+        return target.queue.expired() ? nullptr : &target;
+    }
+
+    static bool is_current(const affinity* target)
+    {
+        return target->thread == std::this_thread::get_id();
+    }
+
+    static std::thread::id thread(const affinity* target)
+    {
+        return target->thread;
+    }
+
+    template <typename Task>
+    static void post(const affinity* target, Task&& task)
+    {
+        if (const std::shared_ptr<dispatch_queue> queue = target->queue.lock())
+            queue->post(std::forward<Task>(task));
+    }
+};
+
+// Work-stealing melo::task_pool of std::threads. Each thread has its own
+// queue, calls posted from a pool thread stay on its queue and the others are
+// spread round-robin, idle threads then take the tasks queued to busy ones.
+class thread_pool : public task_pool
+{
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<delegate<void()>> tasks;
+    };
+
+    const std::size_t count;
+    const std::unique_ptr<Worker[]> workers;
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::atomic<std::size_t> pending{0};
+    std::atomic<std::size_t> idle{0};
+    std::atomic<std::size_t> next{0};
+    bool stopped = false;
+
+    // Pool and queue of the calling thread, when it is a pool thread
+    static inline thread_local const thread_pool* owner = nullptr;
+    static inline thread_local std::size_t self = 0;
+
+    // Oldest task of the thread's own queue, else of the next non-empty one
+    inline bool take(std::size_t index, delegate<void()>& task)
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            Worker& worker = workers[(index + i) % count];
+            std::lock_guard<std::mutex> locker(worker.mutex);
+
+            if (worker.tasks.empty())
+                continue;
+
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+            pending.fetch_sub(1);
+            return true;
+        }
+
+        return false;
+    }
+
+    void work(std::size_t index)
+    {
+        owner = this;
+        self = index;
+
+        for (;;) {
+            // A throwing task must not take the pool thread down, its
+            // exception is dropped
+            if (delegate<void()> task; take(index, task)) {
+                try {
+                    task();
+                } catch (...) {
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> locker(mutex);
+            idle.fetch_add(1);
+            ready.wait(locker, [this] { return stopped || pending.load(); });
+            idle.fetch_sub(1);
+
+            if (stopped && !pending.load())
+                return;
+        }
+    }
+
+public:
+    explicit thread_pool(std::size_t size = std::max(1u, std::thread::hardware_concurrency()))
+        : count(std::max<std::size_t>(size, 1)), workers(new Worker[count])
+    {
+        threads.reserve(count);
+
+        for (std::size_t index = 0; index < count; ++index)
+            threads.emplace_back([this, index] { work(index); });
+    }
+
+    // Runs the tasks already posted, then joins the threads
+    ~thread_pool() override
+    {
+        {
+            std::lock_guard<std::mutex> locker(mutex);
+            stopped = true;
+        }
+        ready.notify_all();
+
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // Pool with one thread per core, destroyed at exit
+    static thread_pool& global()
+    {
+        static thread_pool pool;
+        return pool;
+    }
+
+    std::size_t size() const noexcept { return count; }
+
+    void post(delegate<void()> task) override
+    {
+        Worker& worker = workers[owner == this ? self : next.fetch_add(1, std::memory_order_relaxed) % count];
+        {
+            std::lock_guard<std::mutex> locker(worker.mutex);
+            worker.tasks.push_back(std::move(task));
+        }
+
+        // Sleeping threads check pending under the mutex before waiting
+        pending.fetch_add(1);
+
+        if (idle.load()) {
+            std::lock_guard<std::mutex> locker(mutex);
+            ready.notify_one();
+        }
+    }
+};
+
+} // namespace melo
+
+#endif // BASIC_SIGNAL_H
@@ -0,0 +1,219 @@
+// melo::signal against native QObject signals, direct and queued to a
+// receiver living in another QThread, with int and QByteArray arguments.
+// Built with QT_NO_KEYWORDS, Qt's emit macro would hide basic_signal::emit().
+//
+//   cmake -S bench -B build/bench && cmake --build build/bench
+//   ./build/bench/qt_signal_bench
+
+#include "signal.h"
+#include <benchmark/benchmark.h>
+#include <QCoreApplication>
+#include <QByteArray>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class Emitter : public QObject
+{
+    Q_OBJECT
+
+Q_SIGNALS:
+    void value(int value);
+    void bytes(const QByteArray& bytes);
+};
+
+class Receiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    std::atomic<std::int64_t> calls{0};
+
+    // Spins until `count` calls were received since the last reset
+    void wait(std::int64_t count)
+    {
+        while (calls.load(std::memory_order_acquire) < count)
+            QThread::yieldCurrentThread();
+
+        calls.store(0, std::memory_order_relaxed);
+    }
+
+public Q_SLOTS:
+    void onValue(int value) { calls.fetch_add(value, std::memory_order_release); }
+    void onBytes(const QByteArray& bytes) { benchmark::DoNotOptimize(bytes.constData()); calls.fetch_add(1, std::memory_order_release); }
+};
+
+namespace {
+
+// Receivers living in a started QThread, so every call to them is queued
+class worker
+{
+private:
+    QThread thread;
+
+public:
+    std::vector<std::unique_ptr<Receiver>> receivers;
+
+    explicit worker(std::int64_t count)
+    {
+        for (std::int64_t i = 0; i < count; ++i) {
+            receivers.push_back(std::make_unique<Receiver>());
+            receivers.back()->moveToThread(&thread);
+        }
+
+        thread.start();
+    }
+
+    ~worker()
+    {
+        thread.quit();
+        thread.wait();
+    }
+
+    void wait(std::int64_t count)
+    {
+        for (const std::unique_ptr<Receiver>& receiver : receivers)
+            receiver->wait(count);
+    }
+};
+
+void melo_connect_disconnect(benchmark::State& state)
+{
+    melo::signal<int> sig;
+    Receiver receiver;
+
+    for (auto _ : state) {
+        melo::connection connection = sig.connect(&receiver, &Receiver::onValue);
+        connection.disconnect();
+    }
+}
+BENCHMARK(melo_connect_disconnect);
+
+void qt_connect_disconnect(benchmark::State& state)
+{
+    Emitter emitter;
+    Receiver receiver;
+
+    for (auto _ : state) {
+        const QMetaObject::Connection connection = QObject::connect(&emitter, &Emitter::value, &receiver, &Receiver::onValue);
+        QObject::disconnect(connection);
+    }
+}
+BENCHMARK(qt_connect_disconnect);
+
+void melo_emit_direct(benchmark::State& state)
+{
+    melo::signal<int> sig;
+    std::vector<std::unique_ptr<Receiver>> receivers;
+
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+        receivers.push_back(std::make_unique<Receiver>());
+        sig.connect(receivers.back().get(), &Receiver::onValue);
+    }
+
+    for (auto _ : state)
+        sig.emit(1);
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(melo_emit_direct)->Arg(0)->Arg(1)->Arg(10)->Arg(1000);
+
+void qt_emit_direct(benchmark::State& state)
+{
+    Emitter emitter;
+    std::vector<std::unique_ptr<Receiver>> receivers;
+
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+        receivers.push_back(std::make_unique<Receiver>());
+        QObject::connect(&emitter, &Emitter::value, receivers.back().get(), &Receiver::onValue);
+    }
+
+    for (auto _ : state)
+        Q_EMIT emitter.value(1);
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(qt_emit_direct)->Arg(0)->Arg(1)->Arg(10)->Arg(1000);
+
+void melo_emit_queued(benchmark::State& state)
+{
+    melo::signal<int> sig;
+    worker receivers(state.range(0));
+
+    for (const std::unique_ptr<Receiver>& receiver : receivers.receivers)
+        sig.connect(receiver.get(), &Receiver::onValue);
+
+    for (auto _ : state)
+        sig.emit(1);
+
+    receivers.wait(state.iterations());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(melo_emit_queued)->Arg(1)->Arg(10)->UseRealTime();
+
+void qt_emit_queued(benchmark::State& state)
+{
+    Emitter emitter;
+    worker receivers(state.range(0));
+
+    for (const std::unique_ptr<Receiver>& receiver : receivers.receivers)
+        QObject::connect(&emitter, &Emitter::value, receiver.get(), &Receiver::onValue);
+
+    for (auto _ : state)
+        Q_EMIT emitter.value(1);
+
+    receivers.wait(state.iterations());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(qt_emit_queued)->Arg(1)->Arg(10)->UseRealTime();
+
+// QByteArray is implicitly shared, queued copies only touch its refcount
+void melo_emit_bytes(benchmark::State& state)
+{
+    melo::signal<QByteArray> sig;
+    const QByteArray bytes(static_cast<qsizetype>(state.range(0)), 'x');
+    worker receivers(1);
+
+    sig.connect(receivers.receivers.front().get(), &Receiver::onBytes);
+
+    for (auto _ : state)
+        sig.emit(bytes);
+
+    receivers.wait(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(melo_emit_bytes)->Arg(4)->Arg(1024)->Arg(1 << 20)->UseRealTime();
+
+void qt_emit_bytes(benchmark::State& state)
+{
+    Emitter emitter;
+    const QByteArray bytes(static_cast<qsizetype>(state.range(0)), 'x');
+    worker receivers(1);
+
+    QObject::connect(&emitter, &Emitter::bytes, receivers.receivers.front().get(), &Receiver::onBytes);
+
+    for (auto _ : state)
+        Q_EMIT emitter.bytes(bytes);
+
+    receivers.wait(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(qt_emit_bytes)->Arg(4)->Arg(1024)->Arg(1 << 20)->UseRealTime();
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    QCoreApplication application(argc, argv);
+
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
+
+#include "qt_signal_bench.moc"
@@ -0,0 +1,141 @@
+// signal_stress through qt_executor: emitter threads hammer one melo::signal
+// whose slots are QObject receivers living in started QThreads, so every call
+// is posted with QMetaObject::invokeMethod and run by the receivers' event
+// loops, while churn QThreads connect and disconnect slots of their own and
+// run them with QCoreApplication::processEvents().
+//
+//   qt_signal_stress [--emitters N] [--receivers N] [--slots N] [--churn N]
+//                    [--seconds N] [--interval-us N]
+
+#include "signal.h"
+#include "stress.h"
+#include <QCoreApplication>
+#include <vector>
+
+namespace {
+
+using steady_clock = std::chrono::steady_clock;
+
+class Receiver : public QObject
+{
+private:
+    stress::histogram& latencies;
+
+public:
+    explicit Receiver(stress::histogram& latencies) : latencies(latencies) {}
+
+    void record(const steady_clock::time_point& emitted)
+    {
+        latencies.record(static_cast<std::uint64_t>((steady_clock::now() - emitted).count()));
+    }
+};
+
+// QThread running its event loop, with the receivers of its slots
+class worker
+{
+private:
+    QThread thread;
+    std::vector<std::unique_ptr<Receiver>> receivers;
+
+public:
+    stress::histogram latencies;  // Only touched by the worker's thread until join()
+
+    worker(melo::signal<steady_clock::time_point>& sig, int slots)
+    {
+        for (int i = 0; i < slots; ++i) {
+            receivers.push_back(std::make_unique<Receiver>(latencies));
+            receivers.back()->moveToThread(&thread);
+            sig.connect(receivers.back().get(), &Receiver::record);
+        }
+
+        thread.start();
+    }
+
+    void join()
+    {
+        thread.quit();
+        thread.wait();
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    QCoreApplication application(argc, argv);
+    stress::options settings;
+
+    if (!stress::parse(argc, argv, settings))
+        return 1;
+
+    melo::signal<steady_clock::time_point> sig;
+    std::vector<std::unique_ptr<worker>> workers;
+
+    for (int i = 0; i < settings.receivers; ++i)
+        workers.push_back(std::make_unique<worker>(sig, settings.slots));
+
+    std::atomic<bool> running{true};
+    std::atomic<std::uint64_t> emits{0};
+    std::atomic<std::uint64_t> churned{0};
+    std::vector<std::thread> emitters;
+    std::vector<std::unique_ptr<QThread>> churners;
+
+    for (int i = 0; i < settings.emitters; ++i) {
+        emitters.emplace_back([&] {
+            std::uint64_t count = 0;
+
+            while (running.load(std::memory_order_relaxed)) {
+                sig.emit(steady_clock::now());
+                ++count;
+
+                if (settings.interval_us > 0)
+                    std::this_thread::sleep_for(std::chrono::microseconds(settings.interval_us));
+            }
+
+            emits.fetch_add(count);
+        });
+    }
+
+    // Churn slots are bound to the churn QThread itself and posted to its
+    // event dispatcher, which runs them between each connect and disconnect
+    for (int i = 0; i < settings.churn; ++i) {
+        churners.emplace_back(QThread::create([&] {
+            std::uint64_t count = 0;
+
+            while (running.load(std::memory_order_relaxed)) {
+                melo::connection connection = sig.connect([](const steady_clock::time_point&) {});
+                QCoreApplication::processEvents();
+                connection.disconnect();
+                QCoreApplication::processEvents();
+                ++count;
+            }
+
+            churned.fetch_add(count);
+        }));
+        churners.back()->start();
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(settings.seconds));
+    running.store(false);
+
+    for (std::thread& thread : emitters)
+        thread.join();
+
+    for (const std::unique_ptr<QThread>& thread : churners)
+        thread->wait();
+
+    // Posted events are run in order, once this emission ran on every worker
+    // all the earlier ones did too
+    sig.emit_async(steady_clock::now()).wait();
+
+    stress::histogram latencies;
+
+    for (const std::unique_ptr<worker>& thread : workers) {
+        thread->join();
+        latencies.merge(thread->latencies);
+    }
+
+    stress::report(settings, emits.load(), churned.load(), latencies);
+
+    return 0;
+}
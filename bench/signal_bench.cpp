@@ -0,0 +1,349 @@
+// Microbenchmarks of the std-only core: slot callbacks against std::function,
+// connect/disconnect, direct emit by slot count, queued emit to another thread
+// and argument sizes.
+//
+//   cmake -S bench -B build/bench && cmake --build build/bench
+//   ./build/bench/signal_bench
+
+#include "basic_signal.h"
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <typename... Args>
+using signal = melo::basic_signal<melo::thread_executor, Args...>;
+
+template <typename... Args>
+using queued_signal = melo::basic_signal<melo::queue_executor, Args...>;
+
+// Calls every slot in place whatever the emitting thread, to emit the same
+// signal directly from many threads
+struct inline_executor
+{
+    struct affinity {};
+
+    static affinity current() { return {}; }
+    static const affinity* resolve(const affinity& target) { return &target; }
+    static bool is_current(const affinity*) { return true; }
+    static int thread(const affinity*) { return 0; }
+
+    template <typename Task>
+    static void post(const affinity*, Task&& task)
+    {
+        task();
+    }
+};
+
+// Runs a task on a thread draining its own dispatch_queue
+class worker
+{
+private:
+    std::shared_ptr<melo::dispatch_queue> queue;
+    std::thread thread;
+
+public:
+    worker()
+    {
+        std::atomic<bool> started{false};
+
+        thread = std::thread([this, &started] {
+            queue = melo::dispatch_queue::current();
+            started.store(true);
+            started.notify_one();
+            queue->run();
+        });
+
+        started.wait(false);
+    }
+
+    ~worker()
+    {
+        queue->quit();
+        thread.join();
+    }
+
+    // Connects on the worker's thread so the slot is queued there
+    template <typename Signal, typename Function>
+    void connect(Signal& signal, Function&& function)
+    {
+        std::atomic<bool> done{false};
+
+        queue->post([&] {
+            signal.connect(std::forward<Function>(function));
+            done.store(true);
+            done.notify_one();
+        });
+
+        done.wait(false);
+    }
+};
+
+void connect_disconnect(benchmark::State& state)
+{
+    signal<int> sig;
+
+    for (auto _ : state) {
+        melo::connection connection = sig.connect([](int value) { benchmark::DoNotOptimize(value); });
+        connection.disconnect();
+    }
+}
+BENCHMARK(connect_disconnect);
+
+// Connecting to a signal that already has state.range(0) slots
+void connect_to_populated(benchmark::State& state)
+{
+    signal<int> sig;
+
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+        sig.connect([](int value) { benchmark::DoNotOptimize(value); });
+
+    for (auto _ : state) {
+        melo::connection connection = sig.connect([](int value) { benchmark::DoNotOptimize(value); });
+        connection.disconnect();
+    }
+}
+BENCHMARK(connect_to_populated)->Arg(10)->Arg(1000);
+
+// melo::delegate against the std::function slots used before it: building a
+// slot callback as connect() does, then calling a list of them as emit() does.
+// Three captured pointers fit the delegate's buffer but not libstdc++'s.
+template <typename Callback>
+void callback_construct(benchmark::State& state)
+{
+    std::int64_t a = 0, b = 0, c = 0;
+
+    for (auto _ : state) {
+        Callback callback([pa = &a, pb = &b, pc = &c](int value) { *pa += value; *pb += value; *pc += value; });
+        benchmark::DoNotOptimize(callback);
+    }
+}
+BENCHMARK(callback_construct<melo::delegate<void(int)>>);
+BENCHMARK(callback_construct<std::function<void(int)>>);
+
+template <typename Callback>
+void callback_call(benchmark::State& state)
+{
+    std::int64_t calls = 0;
+    std::vector<Callback> callbacks;
+
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+        callbacks.emplace_back([&calls](int value) { calls += value; });
+
+    for (auto _ : state) {
+        for (const Callback& callback : callbacks)
+            callback(1);
+    }
+
+    benchmark::DoNotOptimize(calls);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(callback_call<melo::delegate<void(int)>>)->Arg(1)->Arg(10);
+BENCHMARK(callback_call<std::function<void(int)>>)->Arg(1)->Arg(10);
+
+void emit_direct(benchmark::State& state)
+{
+    signal<int> sig;
+    std::int64_t calls = 0;
+
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+        sig.connect([&calls](int value) { calls += value; });
+
+    for (auto _ : state)
+        sig.emit(1);
+
+    benchmark::DoNotOptimize(calls);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(emit_direct)->Arg(0)->Arg(1)->Arg(10)->Arg(1000);
+
+// Many threads emitting the same signal, which only read its slot list
+void emit_contended(benchmark::State& state)
+{
+    static melo::basic_signal<inline_executor, int> sig;
+
+    if (state.thread_index() == 0 && sig.slot_count() == 0)
+        sig.connect([](int value) { benchmark::DoNotOptimize(value); });
+
+    for (auto _ : state)
+        sig.emit(1);
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(emit_contended)->Threads(1)->Threads(2)->Threads(4)->Threads(8)->UseRealTime();
+
+// emit() takes its arguments by value, large ones cost the emitter a copy
+// while direct slots then see them by reference
+template <typename Argument>
+void emit_direct_argument(benchmark::State& state)
+{
+    signal<Argument> sig;
+    const Argument argument(static_cast<std::size_t>(state.range(0)), 'x');
+
+    sig.connect([](const Argument& value) { benchmark::DoNotOptimize(value.data()); });
+
+    for (auto _ : state)
+        sig.emit(argument);
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(emit_direct_argument<std::string>)->Arg(8)->Arg(1024);
+BENCHMARK(emit_direct_argument<std::vector<char>>)->Arg(1 << 20);
+
+// Signal with `size` direct slots, built once per size since connecting
+// slots one by one costs O(n^2)
+signal<int>& crowded(std::int64_t size)
+{
+    static std::map<std::int64_t, std::unique_ptr<signal<int>>> signals;
+    std::unique_ptr<signal<int>>& sig = signals[size];
+
+    if (!sig) {
+        sig = std::make_unique<signal<int>>();
+
+        for (std::int64_t i = 0; i < size; ++i)
+            sig->connect([](int value) { benchmark::DoNotOptimize(value); });
+    }
+
+    return *sig;
+}
+
+// The same direct slots called one after the other (0 partitions), or split
+// across the global thread_pool with set_parallel()
+void emit_parallel(benchmark::State& state)
+{
+    signal<int>& sig = crowded(state.range(0));
+    sig.set_parallel({
+        .pool = state.range(1) ? &melo::thread_pool::global() : nullptr,
+        .threshold = 1000,
+        .partitions = static_cast<std::size_t>(state.range(1))
+    });
+
+    for (auto _ : state)
+        sig.emit(1);
+
+    sig.set_parallel({});
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(emit_parallel)->ArgsProduct({{1000, 10000, 100000}, {0, 2, 8}})->ArgNames({"slots", "partitions"})->UseRealTime();
+
+// Emits to a slot queued to another thread, then waits for the last call
+void emit_queued(benchmark::State& state)
+{
+    queued_signal<int> sig;
+    std::atomic<std::int64_t> calls{0};
+    worker receiver;
+
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+        receiver.connect(sig, [&calls](int value) { calls.fetch_add(value, std::memory_order_relaxed); });
+
+    for (auto _ : state)
+        sig.emit(1);
+
+    sig.emit_async(0).wait();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(emit_queued)->Arg(1)->Arg(10)->UseRealTime();
+
+// Queued arguments are copied once per emit into the shared payload
+template <typename Argument>
+void emit_queued_argument(benchmark::State& state)
+{
+    queued_signal<Argument> sig;
+    const Argument argument(static_cast<std::size_t>(state.range(0)), 'x');
+    worker receiver;
+
+    receiver.connect(sig, [](const Argument& value) { benchmark::DoNotOptimize(value.data()); });
+
+    for (auto _ : state)
+        sig.emit(argument);
+
+    sig.emit_async(argument).wait();
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(emit_queued_argument<std::string>)->Arg(8)->Arg(1024)->UseRealTime();
+BENCHMARK(emit_queued_argument<std::vector<char>>)->Arg(1 << 20)->UseRealTime();
+
+// state.range(0) emissions as one emit_batch() call (1) or as a loop of
+// emit() calls (0), to direct slots
+void emit_batch_direct(benchmark::State& state)
+{
+    signal<int> sig;
+    std::int64_t calls = 0;
+    const std::vector<std::tuple<int>> batch(static_cast<std::size_t>(state.range(0)), std::tuple<int>(1));
+
+    for (int i = 0; i < 10; ++i)
+        sig.connect([&calls](int value) { calls += value; });
+
+    for (auto _ : state) {
+        if (state.range(1)) {
+            sig.emit_batch(batch);
+        } else {
+            for (const std::tuple<int>& args : batch)
+                sig.emit(std::get<0>(args));
+        }
+    }
+
+    benchmark::DoNotOptimize(calls);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(emit_batch_direct)->ArgsProduct({{16, 256}, {0, 1}})->ArgNames({"emits", "batch"});
+
+// Same to a slot queued to another thread, a batch is one queued call per
+// receiving thread instead of one per emission
+void emit_batch_queued(benchmark::State& state)
+{
+    queued_signal<int> sig;
+    std::atomic<std::int64_t> calls{0};
+    const std::vector<std::tuple<int>> batch(static_cast<std::size_t>(state.range(0)), std::tuple<int>(1));
+    worker receiver;
+
+    receiver.connect(sig, [&calls](int value) { calls.fetch_add(value, std::memory_order_relaxed); });
+
+    for (auto _ : state) {
+        if (state.range(1)) {
+            sig.emit_batch(batch);
+        } else {
+            for (const std::tuple<int>& args : batch)
+                sig.emit(std::get<0>(args));
+        }
+    }
+
+    sig.emit_async(0).wait();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(emit_batch_queued)->ArgsProduct({{16, 256}, {0, 1}})->ArgNames({"emits", "batch"})->UseRealTime();
+
+// Same queued emit through a melo::event_loop instead of a dispatch_queue
+void emit_queued_event_loop(benchmark::State& state)
+{
+    signal<int> sig;
+    std::atomic<std::int64_t> calls{0};
+    std::shared_ptr<melo::event_loop> loop;
+    std::atomic<bool> started{false};
+
+    std::thread thread([&] {
+        loop = melo::event_loop::current();
+        sig.connect([&calls](int value) { calls.fetch_add(value, std::memory_order_relaxed); });
+        started.store(true);
+        started.notify_one();
+        loop->run();
+    });
+
+    started.wait(false);
+
+    for (auto _ : state)
+        sig.emit(1);
+
+    sig.emit_async(0).wait();
+    loop->quit();
+    thread.join();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(emit_queued_event_loop)->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,131 @@
+// Contention stress test: emitter threads hammer one signal whose slots are
+// queued to receiver threads, while churn threads connect and disconnect
+// slots of their own. Receivers record the emit-to-slot latency of every call
+// in a log-linear histogram, merged and reported when the run ends.
+//
+//   signal_stress [--emitters N] [--receivers N] [--slots N] [--churn N]
+//                 [--seconds N] [--interval-us N]
+
+#include "basic_signal.h"
+#include "stress.h"
+#include <vector>
+
+namespace {
+
+using steady_clock = std::chrono::steady_clock;
+using signal = melo::basic_signal<melo::queue_executor, steady_clock::time_point>;
+
+// Thread draining its own dispatch_queue, with the latencies of its slots
+class receiver
+{
+private:
+    std::shared_ptr<melo::dispatch_queue> queue;
+    std::thread thread;
+
+public:
+    stress::histogram latencies;  // Only touched by the receiver's thread until join()
+
+    receiver(signal& sig, int slots)
+    {
+        std::atomic<bool> started{false};
+
+        thread = std::thread([this, &sig, &started, slots] {
+            queue = melo::dispatch_queue::current();
+
+            for (int i = 0; i < slots; ++i) {
+                sig.connect([this](const steady_clock::time_point& emitted) {
+                    latencies.record(static_cast<std::uint64_t>((steady_clock::now() - emitted).count()));
+                });
+            }
+
+            started.store(true);
+            started.notify_one();
+            queue->run();
+        });
+
+        started.wait(false);
+    }
+
+    void join()
+    {
+        queue->quit();
+        thread.join();
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    stress::options settings;
+
+    if (!stress::parse(argc, argv, settings))
+        return 1;
+
+    signal sig;
+    std::vector<std::unique_ptr<receiver>> receivers;
+
+    for (int i = 0; i < settings.receivers; ++i)
+        receivers.push_back(std::make_unique<receiver>(sig, settings.slots));
+
+    std::atomic<bool> running{true};
+    std::atomic<std::uint64_t> emits{0};
+    std::atomic<std::uint64_t> churned{0};
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < settings.emitters; ++i) {
+        threads.emplace_back([&] {
+            std::uint64_t count = 0;
+
+            while (running.load(std::memory_order_relaxed)) {
+                sig.emit(steady_clock::now());
+                ++count;
+
+                if (settings.interval_us > 0)
+                    std::this_thread::sleep_for(std::chrono::microseconds(settings.interval_us));
+            }
+
+            emits.fetch_add(count);
+        });
+    }
+
+    // Churn slots are queued to the churn thread itself, which drains them
+    // between each connect and disconnect
+    for (int i = 0; i < settings.churn; ++i) {
+        threads.emplace_back([&] {
+            const std::shared_ptr<melo::dispatch_queue>& queue = melo::dispatch_queue::current();
+            std::uint64_t count = 0;
+
+            while (running.load(std::memory_order_relaxed)) {
+                melo::connection connection = sig.connect([](const steady_clock::time_point&) {});
+                queue->drain();
+                connection.disconnect();
+                queue->drain();
+                ++count;
+            }
+
+            churned.fetch_add(count);
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(settings.seconds));
+    running.store(false);
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    // Queues are FIFO, once this emission ran on every receiver all the
+    // earlier ones did too
+    sig.emit_async(steady_clock::now()).wait();
+
+    stress::histogram latencies;
+
+    for (const std::unique_ptr<receiver>& thread : receivers) {
+        thread->join();
+        latencies.merge(thread->latencies);
+    }
+
+    stress::report(settings, emits.load(), churned.load(), latencies);
+
+    return 0;
+}
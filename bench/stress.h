@@ -0,0 +1,141 @@
+// Options, latency histogram and report shared by signal_stress and
+// qt_signal_stress
+
+#ifndef STRESS_H
+#define STRESS_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+namespace stress {
+
+struct options {
+    int emitters = 4;
+    int receivers = 2;
+    int slots = 4;            // Per receiver
+    int churn = 1;
+    int seconds = 5;
+    int interval_us = 0;      // Pause between two emits of one emitter, 0 to emit flat out
+};
+
+// Log-linear histogram of nanoseconds, as in HdrHistogram: each power of two
+// is split into 32 linear sub-buckets, so values are kept within 3%
+class histogram
+{
+private:
+    static constexpr int sub_bits = 5;
+    static constexpr std::uint64_t sub_count = 1 << sub_bits;
+
+    std::array<std::uint64_t, 64 * sub_count> counts{};
+    std::uint64_t total = 0;
+    std::uint64_t maximum = 0;
+
+    static std::size_t index(std::uint64_t value)
+    {
+        if (value < sub_count)
+            return value;
+
+        const int shift = std::bit_width(value) - 1 - sub_bits;
+        return ((shift + 1) << sub_bits) + ((value >> shift) - sub_count);
+    }
+
+    // Lowest value counted in a bucket
+    static std::uint64_t value(std::size_t index)
+    {
+        if (index < sub_count)
+            return index;
+
+        const int shift = static_cast<int>(index >> sub_bits) - 1;
+        return ((index & (sub_count - 1)) + sub_count) << shift;
+    }
+
+public:
+    void record(std::uint64_t nanoseconds)
+    {
+        ++counts[index(nanoseconds)];
+        ++total;
+        maximum = std::max(maximum, nanoseconds);
+    }
+
+    void merge(const histogram& other)
+    {
+        for (std::size_t i = 0; i < counts.size(); ++i)
+            counts[i] += other.counts[i];
+
+        total += other.total;
+        maximum = std::max(maximum, other.maximum);
+    }
+
+    std::uint64_t count() const noexcept { return total; }
+    std::uint64_t max() const noexcept { return maximum; }
+
+    std::uint64_t percentile(double percent) const
+    {
+        const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(percent / 100.0 * static_cast<double>(total) + 0.5));
+        std::uint64_t seen = 0;
+
+        for (std::size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+
+            if (seen >= rank)
+                return value(i);
+        }
+
+        return maximum;
+    }
+};
+
+inline bool parse(int argc, char** argv, options& settings)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view name = argv[i];
+        int* value = nullptr;
+
+        if (name == "--emitters")
+            value = &settings.emitters;
+        else if (name == "--receivers")
+            value = &settings.receivers;
+        else if (name == "--slots")
+            value = &settings.slots;
+        else if (name == "--churn")
+            value = &settings.churn;
+        else if (name == "--seconds")
+            value = &settings.seconds;
+        else if (name == "--interval-us")
+            value = &settings.interval_us;
+
+        if (!value || ++i == argc) {
+            std::fprintf(stderr, "usage: %s [--emitters N] [--receivers N] [--slots N] [--churn N] [--seconds N] [--interval-us N]\n", argv[0]);
+            return false;
+        }
+
+        *value = std::atoi(argv[i]);
+    }
+
+    return true;
+}
+
+inline void report(const options& settings, std::uint64_t emits, std::uint64_t churned, const histogram& latencies)
+{
+    const double seconds = settings.seconds > 0 ? settings.seconds : 1;
+
+    std::printf("emitters %d, receivers %d x %d slots, churn threads %d, %d s\n",
+                settings.emitters, settings.receivers, settings.slots, settings.churn, settings.seconds);
+    std::printf("emits     %llu (%.0f/s)\n", static_cast<unsigned long long>(emits), static_cast<double>(emits) / seconds);
+    std::printf("calls     %llu\n", static_cast<unsigned long long>(latencies.count()));
+    std::printf("churn     %llu connect/disconnect pairs (%.0f/s)\n", static_cast<unsigned long long>(churned), static_cast<double>(churned) / seconds);
+    std::printf("latency   p50 %llu ns, p99 %llu ns, p99.9 %llu ns, max %llu ns\n",
+                static_cast<unsigned long long>(latencies.percentile(50)),
+                static_cast<unsigned long long>(latencies.percentile(99)),
+                static_cast<unsigned long long>(latencies.percentile(99.9)),
+                static_cast<unsigned long long>(latencies.max()));
+}
+
+} // namespace stress
+
+#endif // STRESS_H
@@ -0,0 +1,112 @@
+#ifndef CHROME_TRACER_H
+#define CHROME_TRACER_H
+
+#include "basic_signal.h"
+#include <fstream>
+#include <iomanip>
+#include <string>
+
+namespace melo {
+
+// melo::tracer writing the Chrome trace-event JSON format, to open in
+// chrome://tracing or ui.perfetto.dev. Emits and queued calls are slices on
+// the thread they ran on, linked by one flow arrow from the emit to each
+// queued call it caused. A call dropped or coalesced by a bounded slot leaves
+// an arrow without an end.
+//
+//   melo::chrome_tracer tracer("signals.json");
+//   melo::tracer::install(&tracer);
+class chrome_tracer : public tracer
+{
+private:
+    std::mutex mutex;
+    std::ofstream file;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool first = true;
+
+    // Small sequential numbers read better than hashed std::thread::id
+    static std::uint64_t thread_number()
+    {
+        static std::atomic<std::uint64_t> threads{0};
+        thread_local const std::uint64_t number = threads.fetch_add(1, std::memory_order_relaxed) + 1;
+        return number;
+    }
+
+    void write_name(const char* signal)
+    {
+        for (const char* c = signal ? signal : "signal"; *c; ++c) {
+            if (*c == '"' || *c == '\\')
+                file << '\\' << *c;
+            else if (static_cast<unsigned char>(*c) >= 0x20)
+                file << *c;
+        }
+    }
+
+    // Flow events (phases s and f) link an emit to one of its queued calls by
+    // the flow id of that call
+    void write(char phase, const char* category, const char* signal, std::uint64_t emission, std::uint64_t flow = 0)
+    {
+        const double timestamp = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        const std::uint64_t thread = thread_number();
+
+        std::lock_guard<std::mutex> locker(mutex);
+
+        file << (std::exchange(first, false) ? "\n" : ",\n") << "{\"name\":\"";
+        write_name(signal);
+        file << "\",\"cat\":\"" << category << "\",\"ph\":\"" << phase << "\",\"ts\":" << timestamp
+             << ",\"pid\":1,\"tid\":" << thread;
+
+        if (phase == 's' || phase == 'f')
+            file << ",\"id\":" << flow << (phase == 'f' ? ",\"bp\":\"e\"" : "");
+        else if (phase == 'i')
+            file << ",\"s\":\"t\"";
+
+        file << ",\"args\":{\"emission\":" << emission << "}}";
+    }
+
+public:
+    explicit chrome_tracer(const std::string& path) : file(path)
+    {
+        file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+    }
+
+    ~chrome_tracer() override
+    {
+        if (tracer::current() == this)
+            tracer::install(nullptr);
+
+        file << "\n]}\n";
+    }
+
+    bool is_open() const { return file.is_open(); }
+
+    void emit_begin(const char* signal, std::uint64_t emission) override
+    {
+        write('B', "emit", signal, emission);
+    }
+
+    void emit_end(const char* signal, std::uint64_t emission) override
+    {
+        write('E', "emit", signal, emission);
+    }
+
+    void slot_dispatched(const char* signal, std::uint64_t emission, std::uint64_t flow) override
+    {
+        write(flow ? 's' : 'i', flow ? "queued" : "direct", signal, emission, flow);
+    }
+
+    void queued_begin(const char* signal, std::uint64_t emission, std::uint64_t flow) override
+    {
+        write('B', "queued", signal, emission);
+        write('f', "queued", signal, emission, flow);
+    }
+
+    void queued_end(const char* signal, std::uint64_t emission, std::uint64_t) override
+    {
+        write('E', "queued", signal, emission);
+    }
+};
+
+} // namespace melo
+
+#endif // CHROME_TRACER_H
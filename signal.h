@@ -1,94 +1,209 @@
 #ifndef SIGNAL_H
 #define SIGNAL_H
 
-#include <vector>
+#include "basic_signal.h"
 #include <QThread>
 #include <QPointer>
 #include <QObject>
-#include <functional>
 #include <QMetaObject>
-#include <QReadWriteLock>
-#include <type_traits>
+#include <QThreadPool>
+#include <QAbstractEventDispatcher>
 
 namespace melo {
 
+// Executor dispatching through Qt, queued calls are posted to the event loop
+// of the receiver's thread, or of the connecting thread, with
+// QMetaObject::invokeMethod
+struct qt_executor
+{
+    struct affinity {
+        QPointer<QObject> qobject;  // Receiver, or the thread the slot was connected from
+        bool receiver = false;
+    };
+
+    struct target {
+        QObject* qobject = nullptr;
+        bool receiver = false;
+
+        explicit operator bool() const noexcept { return qobject != nullptr; }
+    };
+
+    static affinity current()
+    {
+        return {QThread::currentThread(), false};
+    }
+
+    template <typename T>
+    static affinity of(T* instance)
+    {
+        if constexpr (std::is_base_of_v<QObject, T>)
+            return {instance, true};
+        else
+            return current();
+    }
+
+    static target resolve(const affinity& slot)
+    {
+        return {slot.qobject.data(), slot.receiver};
+    }
+
+    static bool is_receiver(const affinity& slot)
+    {
+        return slot.receiver;
+    }
+
+    // Receivers may be moved to another thread after connecting, so their
+    // affinity is looked up on each emit
+    static QThread* thread(const target& slot)
+    {
+        return slot.receiver ? slot.qobject->thread() : static_cast<QThread*>(slot.qobject);
+    }
+
+    static bool is_current(const target& slot)
+    {
+        return thread(slot) == QThread::currentThread();
+    }
+
+    // A QThread object lives in the thread that created it, not in the thread
+    // it runs, so calls bound to a thread are posted to its event dispatcher.
+    // Threads without one (not started by QThread) cannot run queued calls.
+    template <typename Task>
+    static void post(const target& slot, Task&& task)
+    {
+        QObject* context = slot.receiver ? slot.qobject : QAbstractEventDispatcher::instance(thread(slot));
+
+        if (context)
+            QMetaObject::invokeMethod(context, std::forward<Task>(task), Qt::QueuedConnection);
+    }
+};
+
 template <typename... Args>
-class signal
+using signal = basic_signal<qt_executor, Args...>;
+
+// melo::task_pool running the calls on a QThreadPool, the global one by default
+class qt_thread_pool : public task_pool
 {
 private:
-    using Callback = std::function<void(Args...)>;
+    QThreadPool* pool;
+
+public:
+    explicit qt_thread_pool(QThreadPool* pool = QThreadPool::globalInstance()) : pool(pool) {}
+
+    // Exceptions thrown by the calls are dropped, as by melo::thread_pool
+    void post(delegate<void()> task) override
+    {
+        pool->start([task = std::move(task)] {
+            try {
+                task();
+            } catch (...) {
+            }
+        });
+    }
+};
+
+// Drains the calling thread's melo::dispatch_queue from its Qt event loop, so
+// slots of basic_signal<queue_executor, Args...> connected from this thread
+// are queued there without a QMetaCallEvent and QCoreApplication::postEvent.
+// Calling it again on the same thread does nothing.
+inline bool integrate_dispatch_queue()
+{
+    thread_local QPointer<QAbstractEventDispatcher> integrated;
+    QAbstractEventDispatcher* dispatcher = QAbstractEventDispatcher::instance();
+
+    if (!dispatcher)
+        return false;
+
+    if (integrated == dispatcher)
+        return true;
 
-    struct Slot {
-        Callback callback;
-        QPointer<QObject> qobject;
+    integrated = dispatcher;
+
+    const std::shared_ptr<dispatch_queue> queue = dispatch_queue::current();
+    const auto drain = [queue] { queue->drain(); };
+
+    queue->set_wakeup([dispatcher = QPointer<QAbstractEventDispatcher>(dispatcher)] {
+        if (dispatcher)
+            dispatcher->wakeUp();
+    });
+
+    QObject::connect(dispatcher, &QAbstractEventDispatcher::awake, dispatcher, drain);
+    QObject::connect(dispatcher, &QAbstractEventDispatcher::aboutToBlock, dispatcher, drain);
+    return true;
+}
+
+// melo::queue_executor following QObject receivers as qt_executor does. Calls
+// to a receiver go through the dispatch_queue of the thread it was connected
+// from while it lives there, and through invokeMethod once it was moved to
+// another thread. Calls to a deleted receiver are skipped, queued ones too.
+struct qt_queue_executor
+{
+    struct affinity {
+        QPointer<QObject> qobject;  // Receiver, null for other slots
+        bool receiver = false;
+        queue_executor::affinity queue;  // Queue of the connecting thread
+        QThread* thread = nullptr;       // Connecting thread
     };
 
-    std::vector<Slot> slots{};
-    QReadWriteLock lock;
+    using target = const affinity*;
 
-    inline void insert(Callback&& callee, QPointer<QObject> obj = nullptr)
+    static affinity current()
     {
-        QWriteLocker locker(&lock);
-        slots.emplace_back(Slot{std::move(callee), obj? obj : QThread::currentThread()});
+        return {nullptr, false, queue_executor::current(), QThread::currentThread()};
     }
 
-public:
-    ~signal() = default;
-    signal() noexcept = default;
+    template <typename T>
+    static affinity of(T* instance)
+    {
+        if constexpr (std::is_base_of_v<QObject, T>)
+            return {instance, true, queue_executor::current(), QThread::currentThread()};
+        else
+            return current();
+    }
 
-    // Support function pointers and lamdas
-    template <typename Function>
-    requires std::invocable<Function, Args...>
-    void connect(Function&& callee)
+    static target resolve(const affinity& slot)
     {
-        insert(std::move(callee));
+        if (slot.receiver)
+            return slot.qobject ? &slot : nullptr;
+
+        return queue_executor::resolve(slot.queue) ? &slot : nullptr;
     }
 
-    // Support member functions with different reference types
-    template <typename ClassType, typename Function>
-    requires std::invocable<Function, ClassType*, Args...>
-    void connect(ClassType* instance, Function&& member_function)
+    static bool is_receiver(const affinity& slot)
     {
-	QPointer<QObject> obj = nullptr;
-		
-        if constexpr (std::is_base_of_v<QObject, ClassType>) {
-            obj = instance;
-	}
-		
-	insert([instance, member_function](Args&&... args) {
-		std::invoke(member_function, instance, std::forward<Args>(args)...);
-	}, obj);
+        return slot.receiver;
     }
 
-    // Support connecting one signal to another
-    template <typename OtherSignal>
-    requires std::same_as<OtherSignal, signal<Args...>>
-    void connect(OtherSignal &other)
+    static QThread* thread(target slot)
     {
-        insert([&other](Args&&... args) { other.emit(std::forward<Args>(args)...); });
+        return slot->receiver ? slot->qobject->thread() : slot->thread;
     }
 
-    void disconnect()
+    static bool is_current(target slot)
     {
-        QWriteLocker locker(&lock);
-        slots.clear();
+        return slot->receiver ? thread(slot) == QThread::currentThread() : queue_executor::is_current(&slot->queue);
     }
 
-    void emit(Args... args)
+    template <typename Task>
+    static void post(target slot, Task&& task)
     {
-        QReadLocker locker(&lock);
-
-        for (const Slot &slot : slots)
-        {
-            if(slot.callback && slot.qobject)
-	    {
-		QMetaObject::invokeMethod(
-			slot.qobject, 
-			[cb = slot.callback, ...args = std::move(args)] { cb(args...); },
-			Qt::AutoConnection
-		);			
+        if (!slot->receiver) {
+            queue_executor::post(&slot->queue, std::forward<Task>(task));
+            return;
+        }
+
+        QObject* const receiver = slot->qobject;
+
+        if (receiver->thread() == slot->thread) {
+            if (const std::shared_ptr<dispatch_queue> queue = slot->queue.queue.lock()) {
+                queue->post([receiver = QPointer<QObject>(receiver), task = std::forward<Task>(task)] {
+                    if (receiver)
+                        task();
+                });
+                return;
             }
         }
+
+        QMetaObject::invokeMethod(receiver, std::forward<Task>(task), Qt::QueuedConnection);
     }
 };
 
@@ -0,0 +1,92 @@
+// block()/unblock(): extra unblock() calls do not wrap the count, and the
+// emissions of a deferred block racing with the last unblock() on another
+// thread are never lost, each one either runs or is replayed.
+
+#include "basic_signal.h"
+#include "check.h"
+#include <thread>
+
+namespace {
+
+using signal = melo::basic_signal<melo::thread_executor, int>;
+
+void unbalanced_unblock()
+{
+    signal sig;
+    int calls = 0;
+
+    sig.connect([&calls](int) { ++calls; });
+    sig.unblock();
+    sig.unblock();
+    CHECK(!sig.blocked());
+
+    sig.emit(1);
+    CHECK(calls == 1);
+
+    sig.block();
+    sig.unblock();
+    sig.unblock();
+    sig.emit(1);
+    CHECK(calls == 2);
+}
+
+// The last emission always reaches the slot, directly or replayed by
+// unblock(), whose replay is queued back to this thread's loop
+void racing_unblock()
+{
+    for (int round = 0; round < 2000; ++round) {
+        signal sig;
+        int last = 0;
+        std::atomic<bool> go{false};
+
+        sig.connect([&last](int value) {
+            if (value == 4)
+                ++last;
+        });
+
+        sig.block(true);
+
+        std::thread unblocker([&] {
+            while (!go.load())
+                ;
+
+            sig.unblock();
+        });
+
+        go.store(true);
+
+        for (int i = 0; i < 5; ++i)
+            sig.emit(i);
+
+        unblocker.join();
+        melo::event_loop::current()->process_events();
+        CHECK(last == 1);
+    }
+}
+
+// emit_async() completes whether it was deferred or ran
+void racing_emit_async()
+{
+    signal sig;
+    sig.connect([](int) {});
+
+    for (int round = 0; round < 1000; ++round) {
+        sig.block(true);
+        std::thread unblocker([&] { sig.unblock(); });
+        const melo::emission done = sig.emit_async(7);
+        unblocker.join();
+
+        while (!done.ready())
+            melo::event_loop::current()->process_events();
+    }
+}
+
+} // namespace
+
+int main()
+{
+    unbalanced_unblock();
+    racing_unblock();
+    racing_emit_async();
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef MELO_TESTS_CHECK_H
+#define MELO_TESTS_CHECK_H
+
+#include <cstdio>
+#include <cstdlib>
+
+// assert() that stays on with NDEBUG
+#define CHECK(condition)                                                                   \
+    do {                                                                                   \
+        if (!(condition)) {                                                                \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            std::abort();                                                                  \
+        }                                                                                  \
+    } while (false)
+
+#endif // MELO_TESTS_CHECK_H
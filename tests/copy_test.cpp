@@ -0,0 +1,22 @@
+// Signals own their slot table, they can be neither copied nor moved, as
+// when their lock was a QReadWriteLock.
+
+#include "basic_signal.h"
+
+namespace {
+
+template <typename Signal>
+constexpr bool pinned = !std::is_copy_constructible_v<Signal> && !std::is_copy_assignable_v<Signal>
+                        && !std::is_move_constructible_v<Signal> && !std::is_move_assignable_v<Signal>;
+
+static_assert(pinned<melo::basic_signal<melo::thread_executor, int>>);
+static_assert(pinned<melo::basic_signal<melo::queue_executor>>);
+static_assert(pinned<melo::basic_signal<melo::thread_executor, int(int)>>);
+static_assert(pinned<melo::basic_signal<melo::thread_executor, int(int), melo::last<int>>>);
+
+} // namespace
+
+int main()
+{
+    return 0;
+}
@@ -0,0 +1,57 @@
+// Slots returning a value connect to void signals, their result is discarded
+// as std::function<void(Args...)> did. Built with -Werror, so copying a
+// delegate holding a captureless lambda must not read uninitialized bytes.
+
+#include "basic_signal.h"
+#include "check.h"
+
+namespace {
+
+using signal = melo::basic_signal<melo::thread_executor, int>;
+
+struct window
+{
+    int closed = 0;
+
+    bool close(int code)
+    {
+        closed += code;
+        return true;
+    }
+};
+
+int doubled(int value) { return value * 2; }
+
+static_assert(std::is_constructible_v<melo::delegate<void(int)>, int (*)(int)>);
+static_assert(std::is_constructible_v<melo::delegate<void(int)>, window*, bool (window::*)(int)>);
+
+} // namespace
+
+int main()
+{
+    signal sig;
+    window target;
+    int calls = 0;
+
+    sig.connect([&calls](int value) { calls += value; return calls; });
+    sig.connect([](int value) { return value + 1; });
+    sig.connect(&doubled);
+    sig.connect(&target, &window::close);
+    sig.emit(1);
+
+    CHECK(calls == 1);
+    CHECK(target.closed == 1);
+
+    // Copies and moves of a delegate holding an empty lambda
+    melo::delegate<void(int)> empty([](int) {});
+    melo::delegate<void(int)> copy = empty;
+    melo::delegate<void(int)> moved = std::move(copy);
+    moved(1);
+    CHECK(empty && moved);
+
+    const melo::delegate<int(int)> value(&doubled);
+    CHECK(value(3) == 6);
+
+    melo::watchdog watchdog(std::chrono::seconds(1), [](const melo::slow_call&) {});
+    return 0;
+}
@@ -0,0 +1,104 @@
+// dispatch_queue wakeups: a consumer sleeping on its own condition, woken
+// only through set_wakeup() while another thread keeps replacing the
+// callback. A lost wakeup deadlocks the ping-pong, caught by the test timeout.
+// A queue closed by its thread exiting rejects posts instead of spinning.
+
+#include "basic_signal.h"
+#include "check.h"
+#include <condition_variable>
+#include <thread>
+
+namespace {
+
+constexpr int rounds = 200000;
+
+void ping_pong()
+{
+    std::shared_ptr<melo::dispatch_queue> queue;
+    std::mutex mutex;
+    std::condition_variable woken_up;
+    bool woken = false;
+    std::atomic<bool> stop{false}, ready{false};
+
+    const auto wake = [&] {
+        std::lock_guard<std::mutex> locker(mutex);
+        woken = true;
+        woken_up.notify_one();
+    };
+
+    std::thread consumer([&] {
+        queue = melo::dispatch_queue::current();
+        queue->set_wakeup(wake);
+        ready.store(true);
+        ready.notify_one();
+
+        while (!stop.load()) {
+            queue->drain();
+            std::unique_lock<std::mutex> locker(mutex);
+            woken_up.wait(locker, [&] { return woken; });
+            woken = false;
+        }
+
+        queue->drain();
+    });
+
+    ready.wait(false);
+
+    std::thread setter([&] {
+        for (int i = 0; i < 1000; ++i)
+            queue->set_wakeup(wake);
+    });
+
+    std::atomic<int> done{0};
+
+    for (int i = 0; i < rounds; ++i) {
+        CHECK(queue->post([&] { done.fetch_add(1); }));
+
+        while (done.load() != i + 1)
+            std::this_thread::yield();
+    }
+
+    setter.join();
+    stop.store(true);
+    queue->post([] {});
+    consumer.join();
+    CHECK(done.load() == rounds);
+}
+
+void closed_on_exit()
+{
+    std::shared_ptr<melo::dispatch_queue> queue;
+    std::thread owner([&] { queue = melo::dispatch_queue::current(); });
+    owner.join();
+
+    CHECK(queue->is_closed());
+    CHECK(!queue->post([] {}));
+
+    // A producer waiting for room in a queue whose owner stopped draining,
+    // until the owner exits
+    std::atomic<int> phase{0};
+
+    std::thread stalled([&] {
+        queue = melo::dispatch_queue::current();
+
+        while (queue->try_post([] {}))
+            ;
+
+        phase.store(1);
+        phase.notify_one();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    });
+
+    phase.wait(0);
+    CHECK(!queue->post([] {}));
+    stalled.join();
+}
+
+} // namespace
+
+int main()
+{
+    ping_pong();
+    closed_on_exit();
+    return 0;
+}
@@ -0,0 +1,87 @@
+// A bounded slot throwing from a queued call leaves its mailbox unscheduled
+// with payloads still pending. The next emission must schedule it again, for
+// every overflow policy, instead of stalling the slot for good.
+
+#include "basic_signal.h"
+#include "check.h"
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+using signal = melo::basic_signal<melo::queue_executor, int>;
+
+// Threads take turns by setting the step the other one waits for
+void await(const std::atomic<int>& step, int value)
+{
+    for (int current = step.load(); current != value; current = step.load())
+        step.wait(current);
+}
+
+void advance(std::atomic<int>& step, int value)
+{
+    step.store(value);
+    step.notify_all();
+}
+
+void throwing_slot(melo::overflow_policy policy)
+{
+    signal sig;
+    std::vector<int> received;
+    std::atomic<int> step{0};
+    bool threw = false;
+
+    std::thread receiver([&] {
+        const std::shared_ptr<melo::dispatch_queue> queue = melo::dispatch_queue::current();
+
+        sig.connect([&received](int value) {
+            if (value == 1)
+                throw std::runtime_error("slot failed");
+
+            received.push_back(value);
+        }, {.queue_limit = 2, .overflow = policy});
+
+        advance(step, 1);
+        await(step, 2);
+
+        try {
+            queue->drain();
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+
+        advance(step, 3);
+        await(step, 4);
+        queue->drain();
+    });
+
+    await(step, 1);
+    sig.emit(1);
+    sig.emit(2);
+    advance(step, 2);
+
+    // The delivery stopped at the throwing call, 2 is left in the mailbox
+    await(step, 3);
+    CHECK(threw);
+
+    sig.emit(3);
+
+    if (policy != melo::overflow_policy::block) {
+        sig.emit(4);
+        sig.emit(5);
+    }
+
+    advance(step, 4);
+    receiver.join();
+    CHECK(received.size() == 2);
+}
+
+} // namespace
+
+int main()
+{
+    for (melo::overflow_policy policy : {melo::overflow_policy::block, melo::overflow_policy::drop_newest, melo::overflow_policy::drop_oldest, melo::overflow_policy::coalesce})
+        throwing_slot(policy);
+
+    return 0;
+}
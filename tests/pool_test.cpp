@@ -0,0 +1,49 @@
+// Pooled slots are not tied to the thread they were connected from: they keep
+// running, from emit() and emit_batch(), after that thread exited.
+
+#include "basic_signal.h"
+#include "check.h"
+#include <thread>
+
+namespace {
+
+using signal = melo::basic_signal<melo::thread_executor, int>;
+
+struct counter
+{
+    std::atomic<int> calls{0};
+
+    void add(int value) { calls.fetch_add(value); }
+};
+
+} // namespace
+
+int main()
+{
+    melo::thread_pool pool(2);
+    signal sig;
+    std::atomic<int> calls{0};
+    counter receiver;
+
+    std::thread connecting([&] {
+        sig.connect([&calls](int value) { calls.fetch_add(value); }, {.pool = &pool});
+        sig.connect(&receiver, &counter::add, {.pool = &pool});
+    });
+    connecting.join();
+
+    CHECK(sig.slot_count() == 2);
+
+    sig.emit_async(1).wait();
+    CHECK(calls.load() == 1);
+    CHECK(receiver.calls.load() == 1);
+
+    const std::vector<std::tuple<int>> batch{{2}, {3}};
+    sig.emit_batch(batch);
+
+    // Each element is a separate pool task, waited for by the test timeout
+    while (calls.load() != 6 || receiver.calls.load() != 6)
+        std::this_thread::yield();
+
+    CHECK(sig.slot_count() == 2);
+    return 0;
+}
@@ -0,0 +1,53 @@
+// Replaced slot snapshots are freed once no emission iterates them, so
+// disconnect() and destroying a signal release what the slots captured.
+
+#include "basic_signal.h"
+#include "check.h"
+#include <thread>
+
+namespace {
+
+using signal = melo::basic_signal<melo::thread_executor, int>;
+
+} // namespace
+
+int main()
+{
+    const auto state = std::make_shared<int>(0);
+
+    {
+        signal sig;
+        sig.connect([state](int) {});
+        sig.emit(1);
+        sig.disconnect();
+        CHECK(state.use_count() == 1);
+
+        sig.connect([state](int) {});
+        sig.emit(1);
+    }
+
+    CHECK(state.use_count() == 1);
+
+    // An emission running on another thread holds the snapshot until it ends
+    signal sig;
+    std::atomic<int> phase{0};
+
+    std::thread emitter([&] {
+        sig.connect([state, &phase](int) {
+            phase.store(1);
+            phase.notify_one();
+            phase.wait(1);
+        });
+        sig.emit(1);
+    });
+
+    phase.wait(0);
+    sig.disconnect();
+    CHECK(state.use_count() == 2);
+
+    phase.store(2);
+    phase.notify_one();
+    emitter.join();
+    CHECK(state.use_count() == 1);
+    return 0;
+}
@@ -0,0 +1,52 @@
+// The watchdog reports from the destructor timing a slot call, a report
+// callback throwing there must not terminate the program, neither on a call
+// returning normally nor on one unwinding from the slot's own exception.
+
+#include "basic_signal.h"
+#include "check.h"
+#include <stdexcept>
+
+namespace {
+
+using signal = melo::basic_signal<melo::thread_executor, int>;
+
+} // namespace
+
+int main()
+{
+    int reports = 0;
+    melo::watchdog watchdog(std::chrono::nanoseconds(-1), [&reports](const melo::slow_call& call) {
+        ++reports;
+        throw std::runtime_error(call.signal);
+    }, 1);
+
+    melo::watchdog::install(&watchdog);
+
+    signal sig;
+    int calls = 0;
+
+    sig.set_name("sig");
+    sig.connect([&calls](int) { ++calls; });
+    sig.emit(1);
+
+    CHECK(calls == 1);
+    CHECK(reports == 1);
+
+    signal throwing;
+    bool caught = false;
+
+    throwing.set_name("throwing");
+    throwing.connect([](int) { throw std::logic_error("slot"); });
+
+    try {
+        throwing.emit(1);
+    } catch (const std::logic_error&) {
+        caught = true;
+    }
+
+    CHECK(caught);
+    CHECK(reports == 2);
+
+    melo::watchdog::install(nullptr);
+    return 0;
+}